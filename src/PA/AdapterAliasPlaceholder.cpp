@@ -41,31 +41,10 @@ bool canResolveInnerSpec(std::string_view innerSpec, const IContext* targetCtx,
         return false;
     }
 
-    std::string content(innerSpec);
-    size_t      pipePos         = content.find('|');
-    std::string tokenSearchPart = pipePos == std::string::npos ? content : content.substr(0, pipePos);
-
-    for (size_t splitPos = tokenSearchPart.length();;) {
-        std::string potentialToken = tokenSearchPart.substr(0, splitPos);
-        auto        lookup         = registry.findPlaceholder(potentialToken, targetCtx);
-
-        if (lookup.placeholder) {
-            if (splitPos == tokenSearchPart.length() || tokenSearchPart[splitPos] == ':') {
-                return true;
-            }
-        }
-
-        if (splitPos == 0) {
-            break;
-        }
-        size_t prevColon = tokenSearchPart.rfind(':', splitPos - 1);
-        if (prevColon == std::string::npos) {
-            break;
-        }
-        splitPos = prevColon;
-    }
-
-    return false;
+    RegistryReadGuard guard(registry);
+    std::string_view  tokenSearchPart = innerSpec.substr(0, innerSpec.find('|'));
+    size_t            tokenLength     = 0;
+    return registry.findLongestPlaceholder(guard, tokenSearchPart, targetCtx, tokenLength).placeholder != nullptr;
 }
 
 } // namespace
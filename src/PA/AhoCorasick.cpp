@@ -0,0 +1,112 @@
+// src/PA/AhoCorasick.cpp
+#include "PA/AhoCorasick.h"
+
+namespace PA {
+
+std::unique_ptr<const AhoCorasick> AhoCorasick::build(const std::vector<std::string_view>& patterns) {
+    std::unique_ptr<AhoCorasick> ac(new AhoCorasick());
+
+    // 只为模式中出现过的字节分配独立的字节类，转移表的宽度因此只与模式的字母表大小有关
+    ac->mByteClass.assign(256, 0);
+    uint16_t classes = 1;
+    bool     any     = false;
+    for (std::string_view pattern : patterns) {
+        any = any || !pattern.empty();
+        for (char ch : pattern) {
+            auto& cls = ac->mByteClass[static_cast<unsigned char>(ch)];
+            if (cls == 0) {
+                cls = classes++;
+            }
+        }
+    }
+    if (!any) {
+        return nullptr;
+    }
+    ac->mStride = classes;
+
+    constexpr uint32_t kMissing = UINT32_MAX;
+    auto               addState = [&](uint32_t depth) {
+        ac->mTransitions.resize(ac->mTransitions.size() + ac->mStride, kMissing);
+        ac->mDepth.push_back(depth);
+        ac->mOutput.push_back(kNoPattern);
+        return static_cast<uint32_t>(ac->mDepth.size() - 1);
+    };
+
+    // 字典树
+    addState(0);
+    ac->mPatternLength.reserve(patterns.size());
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        std::string_view pattern = patterns[i];
+        ac->mPatternLength.push_back(static_cast<uint32_t>(pattern.size()));
+        if (pattern.empty()) {
+            continue;
+        }
+        uint32_t state = 0;
+        for (char ch : pattern) {
+            size_t slot = static_cast<size_t>(state) * ac->mStride + ac->mByteClass[static_cast<unsigned char>(ch)];
+            if (ac->mTransitions[slot] == kMissing) {
+                uint32_t child        = addState(ac->mDepth[state] + 1);
+                ac->mTransitions[slot] = child;
+            }
+            state = ac->mTransitions[slot];
+        }
+        ac->mOutput[state] = static_cast<uint32_t>(i);
+    }
+
+    // 按层遍历补全失配转移：缺失的转移沿失配链取值，输出继承失配状态的最长模式
+    std::vector<uint32_t> fail(ac->mDepth.size(), 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(ac->mDepth.size());
+    for (size_t cls = 0; cls < ac->mStride; ++cls) {
+        uint32_t& to = ac->mTransitions[cls];
+        if (to == kMissing) {
+            to = 0;
+        } else {
+            queue.push_back(to);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t state = queue[head];
+        if (ac->mOutput[state] == kNoPattern) {
+            ac->mOutput[state] = ac->mOutput[fail[state]];
+        }
+        for (size_t cls = 0; cls < ac->mStride; ++cls) {
+            size_t    slot       = static_cast<size_t>(state) * ac->mStride + cls;
+            uint32_t  fallback   = ac->mTransitions[static_cast<size_t>(fail[state]) * ac->mStride + cls];
+            uint32_t& transition = ac->mTransitions[slot];
+            if (transition == kMissing) {
+                transition = fallback;
+            } else {
+                fail[transition] = fallback;
+                queue.push_back(transition);
+            }
+        }
+    }
+    return ac;
+}
+
+std::optional<AhoCorasick::Match> AhoCorasick::findLeftmostLongest(std::string_view input, size_t from) const {
+    std::optional<Match> best;
+    uint32_t             state = 0;
+    for (size_t pos = from; pos < input.size(); ++pos) {
+        state          = next(state, static_cast<unsigned char>(input[pos]));
+        const size_t e = pos + 1;
+
+        // 当前状态的前缀覆盖了所有仍可能延续的匹配起点；它们都在已记录的匹配起点之后时，结果已确定
+        if (best && e - mDepth[state] > best->begin) {
+            return best;
+        }
+
+        // 以 pos 结尾的最长模式起点最靠左；起点相同时后出现的匹配更长
+        uint32_t pattern = mOutput[state];
+        if (pattern != kNoPattern) {
+            size_t begin = e - mPatternLength[pattern];
+            if (!best || begin < best->begin || (begin == best->begin && e > best->end)) {
+                best = Match{begin, e, pattern};
+            }
+        }
+    }
+    return best;
+}
+
+} // namespace PA
@@ -0,0 +1,49 @@
+// src/PA/AhoCorasick.h
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace PA {
+
+/**
+ * @brief 多模式字符串匹配（Aho–Corasick 自动机）
+ * 构建时把所有模式合并为一棵字典树并补全失配转移，得到按字节类压缩的稠密 DFA；
+ * 查找时每个字节只做一次查表，与模式数量无关。按字节匹配，模式区分大小写。
+ * 匹配语义为最左最长：起点最靠左的匹配优先，同一起点取最长的模式；多次查找的结果互不重叠。
+ */
+class AhoCorasick {
+public:
+    struct Match {
+        size_t begin{};
+        size_t end{};
+        size_t pattern{}; // 模式在构建时的下标
+    };
+
+    // 构建自动机；空模式被忽略，没有非空模式时返回 nullptr
+    static std::unique_ptr<const AhoCorasick> build(const std::vector<std::string_view>& patterns);
+
+    // 从 from 开始查找最左最长匹配
+    std::optional<Match> findLeftmostLongest(std::string_view input, size_t from) const;
+
+private:
+    static constexpr uint32_t kNoPattern = UINT32_MAX;
+
+    AhoCorasick() = default;
+
+    uint32_t next(uint32_t state, unsigned char c) const noexcept {
+        return mTransitions[static_cast<size_t>(state) * mStride + mByteClass[c]];
+    }
+
+    std::vector<uint16_t> mByteClass;   // 字节到字节类的映射；不出现在任何模式中的字节归为类 0
+    size_t                mStride{};    // 字节类数量
+    std::vector<uint32_t> mTransitions; // 状态 × 字节类 的完整转移表，状态 0 为根
+    std::vector<uint32_t> mDepth;       // 状态对应的前缀长度
+    std::vector<uint32_t> mOutput;      // 以该状态结尾的最长模式（含经失配链可达的后缀）
+    std::vector<uint32_t> mPatternLength;
+};
+
+} // namespace PA
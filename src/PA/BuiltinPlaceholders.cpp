@@ -3,6 +3,7 @@
 
 #include "PA/Placeholders/ActorPlaceholders.h"
 #include "PA/Placeholders/ContextAliasPlaceholders.h"
+#include "PA/Placeholders/MathPlaceholders.h"
 #include "PA/Placeholders/MobPlaceholders.h"
 #include "PA/Placeholders/PlayerPlaceholders.h"
 #include "PA/Placeholders/ServerPlaceholders.h"
@@ -22,6 +23,9 @@ void registerAllBuiltinPlaceholders(IPlaceholderService* svc) {
     static int kBuiltinFactoryOwner = 0;
     void*      factoryOwner         = &kBuiltinFactoryOwner;
 
+    // 全部内置占位符只发布一次快照
+    PlaceholderBatch batch(svc);
+
     // 注册所有内置上下文工厂，使别名占位符能通过工厂机制构造上下文
     svc->registerContextFactory(ActorContext::kTypeId,          ActorContext::factory,          factoryOwner);
     svc->registerContextFactory(MobContext::kTypeId,            MobContext::factory,            factoryOwner);
@@ -34,6 +38,7 @@ void registerAllBuiltinPlaceholders(IPlaceholderService* svc) {
 
     registerActorPlaceholders(svc);
     registerContextAliasPlaceholders(svc);
+    registerMathPlaceholders(svc);
     registerMobPlaceholders(svc);
     registerPlayerPlaceholders(svc);
     registerServerPlaceholders(svc);
@@ -0,0 +1,74 @@
+// src/PA/CompiledTemplate.h
+#pragma once
+
+#include "PA/FormatCache.h"
+#include "PA/PlaceholderAPI.h"
+#include "PA/PlaceholderProcessor.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PA {
+
+struct CachedEntry;
+
+// 模板片段：字面量或占位符，范围均指向 CompiledTemplate::source
+struct TemplateSegment {
+    size_t offset{};        // 完整文本起始位置（占位符含定界符）
+    size_t length{};        // 完整文本长度
+    size_t contentOffset{}; // 占位符内容起始位置（仅占位符有效）
+    size_t contentLength{}; // 占位符内容长度（仅占位符有效）
+    bool   isPlaceholder{};
+};
+
+// 已解析的占位符节点：token 查找、参数分流与格式化参数解析均已完成
+struct BoundPlaceholder {
+    static constexpr size_t kNoMemoSlot = static_cast<size_t>(-1);
+
+    const IPlaceholder*                placeholder = nullptr; // 为空表示未解析，按原文输出
+    const IExtendedPlaceholder*        extended    = nullptr; // placeholder 实现了 IExtendedPlaceholder 时指向它
+    const CachedEntry*                 cachedEntry = nullptr;
+    std::string                        paramPart;
+    SeparatedParams                    separated;
+    std::vector<std::string>           argStorage;
+    std::vector<std::string_view>      args;       // 指向 argStorage
+    bool                               passArgs{}; // 是否走 evaluateWithArgs
+    FormatCache::ParamsHandle          formatting; // 为空表示无格式化参数；解析结果与其他模板共享
+    bool                               tickStable{}; // 未缓存且 tick 稳定，EvaluationScope 内按实例备忘
+    size_t                             memoSlot = kNoMemoSlot; // 同一占位符与求值参数在模板中重复出现时共用的备忘槽位
+};
+
+// 某一上下文类型在某一快照版本下的绑定结果，创建后不再修改
+struct TemplateBinding {
+    uint64_t                      contextTypeId{};
+    uint64_t                      registryVersion{};
+    uint64_t                      formatGeneration{}; // 绑定开始时 FormatCache 的代数，变化后格式化参数需重新解析
+    std::shared_ptr<const void>   snapshotGuard; // 持有绑定时的快照，nodes 中的指针均借用自它
+    std::vector<BoundPlaceholder> nodes;         // 与 segments 中的占位符片段按顺序一一对应
+    size_t                        memoSlots{};   // 重复出现的 {占位符, 求值参数} 组数，渲染时每组只求值一次
+};
+
+/**
+ * @brief 预编译模板
+ * 文本扫描结果与上下文无关，只在 compile 时做一次；
+ * 占位符解析结果依赖上下文类型和注册表快照，按上下文类型懒绑定，快照版本或 FormatCache 代数变化后自动重新绑定。
+ */
+struct CompiledTemplate {
+    std::string                  source;
+    std::vector<TemplateSegment> segments;
+    size_t                       placeholderCount{};
+
+    // 按上下文类型缓存的绑定（数量通常只有个位数，线性查找即可）
+    mutable std::mutex                                          bindingMutex;
+    mutable std::vector<std::shared_ptr<const TemplateBinding>> bindings;
+
+    std::string_view text(size_t offset, size_t length) const {
+        return std::string_view(source).substr(offset, length);
+    }
+};
+
+} // namespace PA
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 struct Config {
     int  version           = 1;
     bool debugMode         = false; // 是否启用调试模式，启用后会在占位符解析失败时输出警告
@@ -8,4 +10,11 @@ struct Config {
     int  asyncThreadPoolQueueSize = 0; // 异步线程池的队列上限，0 表示无限制
     int  asyncPlaceholderTimeoutMs = 2000; // 异步占位符的超时时间（毫秒）
     int  formatHardLimit{0}; // 格式化输出硬上限，0表示无限制
+    int  formatCacheSize = 1024; // 格式化参数解析结果缓存的条目上限，0 表示禁用
+    int  mathExpressionCacheSize = 256; // {math}/{calc} 表达式编译结果缓存的条目上限，0 表示禁用
+    int  valueCacheMaxEntries = 65536; // 缓存占位符值缓存的条目上限，0 表示禁用
+    int  valueCacheMaxMemoryMB = 64;   // 缓存占位符值缓存的内存上限（MB，估算值）
+    int  valueCachePlaceholderQuota = 25; // 单个占位符最多占用值缓存的百分比，0 表示不限
+    int  valueCacheSingleFlightWaitMs = 100; // 单飞占位符并发未命中时等待在途求值的最长时间（毫秒），超时后自行求值
+    std::string regexEngine = "linear"; // regex_map 的正则引擎："linear" 为线性时间引擎（不支持的语法自动回退），"std" 为 std::regex
 };
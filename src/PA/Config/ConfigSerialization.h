@@ -13,5 +13,12 @@ NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(
     asyncThreadPoolSize,
     asyncThreadPoolQueueSize,
     asyncPlaceholderTimeoutMs,
-    formatHardLimit
+    formatHardLimit,
+    formatCacheSize,
+    mathExpressionCacheSize,
+    valueCacheMaxEntries,
+    valueCacheMaxMemoryMB,
+    valueCachePlaceholderQuota,
+    valueCacheSingleFlightWaitMs,
+    regexEngine
 )
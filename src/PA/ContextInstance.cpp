@@ -0,0 +1,71 @@
+// src/PA/ContextInstance.cpp
+#include "PA/ContextInstance.h"
+
+#include <bit>
+
+namespace PA {
+
+namespace {
+
+uint64_t addressId(const void* object) noexcept { return reinterpret_cast<uintptr_t>(object); }
+
+uint64_t hashedId(std::string_view key) noexcept {
+    return key.empty() ? 0 : fnv1a64_constexpr(key.data(), key.size()) | kHashedInstanceIdBit;
+}
+
+} // namespace
+
+uint64_t resolveInstanceId(const IContext* ctx, std::string* exactKey) noexcept {
+    if (!ctx) {
+        return 0;
+    }
+
+    // 同一对象的 Player/Mob/Actor 视图取同一地址，共享同一 id
+    switch (ctx->typeId()) {
+    case PlayerContext::kTypeId:
+        return addressId(static_cast<const PlayerContext*>(ctx)->player);
+    case MobContext::kTypeId:
+        return addressId(static_cast<const MobContext*>(ctx)->mob);
+    case ActorContext::kTypeId:
+        return addressId(static_cast<const ActorContext*>(ctx)->actor);
+    case BlockContext::kTypeId:
+        return addressId(static_cast<const BlockContext*>(ctx)->block);
+    case ItemStackBaseContext::kTypeId:
+        return addressId(static_cast<const ItemStackBaseContext*>(ctx)->itemStackBase);
+    case ContainerContext::kTypeId:
+        return addressId(static_cast<const ContainerContext*>(ctx)->container);
+    case BlockActorContext::kTypeId:
+        return addressId(static_cast<const BlockActorContext*>(ctx)->blockActor);
+    case WorldCoordinateContext::kTypeId: {
+        // 坐标按位组成 16 字节实例键，无需格式化字符串
+        const auto& data = static_cast<const WorldCoordinateContext*>(ctx)->data;
+        if (!data) {
+            return 0;
+        }
+        const uint32_t parts[] = {
+            std::bit_cast<uint32_t>(data->pos.x),
+            std::bit_cast<uint32_t>(data->pos.y),
+            std::bit_cast<uint32_t>(data->pos.z),
+            static_cast<uint32_t>(static_cast<int>(data->dimensionId))
+        };
+        std::string_view key(reinterpret_cast<const char*>(parts), sizeof(parts));
+        if (exactKey) {
+            exactKey->assign(key);
+        }
+        return hashedId(key);
+    }
+    default:
+        break;
+    }
+
+    std::string key = ctx->getContextInstanceKey();
+    uint64_t    id  = hashedId(key);
+    if (exactKey && id != 0) {
+        *exactKey = std::move(key);
+    }
+    return id;
+}
+
+uint64_t IContext::instanceId() const noexcept { return resolveInstanceId(this, nullptr); }
+
+} // namespace PA
@@ -0,0 +1,41 @@
+// src/PA/ContextInstance.h
+#pragma once
+
+#include "PA/PlaceholderAPI.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace PA {
+
+// 实例 id 的最高位：置位表示 id 取自哈希，不能单独区分实例
+inline constexpr uint64_t kHashedInstanceIdBit = 1ull << 63;
+
+/**
+ * @brief 取上下文实例 id（IContext::instanceId() 的实现）
+ * 内置上下文按 typeId() 识别，直接取对象地址；其他上下文只通过 getContextInstanceKey() 访问，
+ * 不调用外部模块编译的上下文上任何新增的虚函数。
+ * @param exactKey 非空且 id 取自哈希时，写入用于精确比较的实例键
+ */
+uint64_t resolveInstanceId(const IContext* ctx, std::string* exactKey) noexcept;
+
+/**
+ * @brief 缓存值与 tick 备忘使用的上下文实例标识
+ * 内置上下文的 id 与实例一一对应，exactKey() 为空；id 取自哈希时另存实例键原文，
+ * 缓存与备忘在 id 相同时再比较它，不会把一个实例的值返回给另一个实例。
+ * 实例键作为 key 的独立字段，不混入占位符参数。ctx 为 nullptr 时 id 为 0。
+ */
+class ContextInstanceKey {
+public:
+    explicit ContextInstanceKey(const IContext* ctx) : mId(resolveInstanceId(ctx, &mExactKey)) {}
+
+    uint64_t         id() const noexcept { return mId; }
+    std::string_view exactKey() const noexcept { return mExactKey; }
+
+private:
+    std::string mExactKey; // 先于 mId 声明：构造 mId 时写入
+    uint64_t    mId{};
+};
+
+} // namespace PA
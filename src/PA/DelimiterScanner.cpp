@@ -0,0 +1,181 @@
+// src/PA/DelimiterScanner.cpp
+#include "PA/DelimiterScanner.h"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define PA_SCANNER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 需要为单个函数开启 AVX2 代码生成；MSVC 可直接使用内建函数
+#if defined(PA_SCANNER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PA_TARGET_AVX2
+#endif
+
+namespace PA {
+
+namespace {
+
+inline void appendBits(uint32_t mask, size_t base, std::vector<size_t>& out) {
+    while (mask != 0) {
+        out.push_back(base + static_cast<size_t>(std::countr_zero(mask)));
+        mask &= mask - 1;
+    }
+}
+
+bool scanScalar(std::string_view text, size_t from, std::vector<size_t>& out) {
+    bool hasOpen = false;
+    for (size_t i = from; i < text.length(); ++i) {
+        switch (text[i]) {
+        case '{':
+        case '%':
+            hasOpen = true;
+            [[fallthrough]];
+        case '}':
+        case '\\':
+            out.push_back(i);
+            break;
+        default:
+            break;
+        }
+    }
+    return hasOpen;
+}
+
+#ifdef PA_SCANNER_X86
+
+// x64 下 SSE2 为基线指令集，无需运行时检测
+bool scanSse2(std::string_view text, std::vector<size_t>& out) {
+    const char*   data      = text.data();
+    const size_t  length    = text.length();
+    const __m128i lbrace    = _mm_set1_epi8('{');
+    const __m128i rbrace    = _mm_set1_epi8('}');
+    const __m128i percent   = _mm_set1_epi8('%');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    bool   hasOpen = false;
+    size_t i       = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i  chunk    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i  opens    = _mm_or_si128(_mm_cmpeq_epi8(chunk, lbrace), _mm_cmpeq_epi8(chunk, percent));
+        __m128i  others   = _mm_or_si128(_mm_cmpeq_epi8(chunk, rbrace), _mm_cmpeq_epi8(chunk, backslash));
+        uint32_t openMask = static_cast<uint32_t>(_mm_movemask_epi8(opens));
+        uint32_t mask     = openMask | static_cast<uint32_t>(_mm_movemask_epi8(others));
+        if (mask != 0) {
+            hasOpen |= openMask != 0;
+            appendBits(mask, i, out);
+        }
+    }
+    bool tailOpen = scanScalar(text, i, out);
+    return hasOpen || tailOpen;
+}
+
+PA_TARGET_AVX2 bool scanAvx2(std::string_view text, std::vector<size_t>& out) {
+    const char*   data      = text.data();
+    const size_t  length    = text.length();
+    const __m256i lbrace    = _mm256_set1_epi8('{');
+    const __m256i rbrace    = _mm256_set1_epi8('}');
+    const __m256i percent   = _mm256_set1_epi8('%');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+
+    bool   hasOpen = false;
+    size_t i       = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i  chunk    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i  opens    = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lbrace), _mm256_cmpeq_epi8(chunk, percent));
+        __m256i  others   = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, rbrace), _mm256_cmpeq_epi8(chunk, backslash));
+        uint32_t openMask = static_cast<uint32_t>(_mm256_movemask_epi8(opens));
+        uint32_t mask     = openMask | static_cast<uint32_t>(_mm256_movemask_epi8(others));
+        if (mask != 0) {
+            hasOpen |= openMask != 0;
+            appendBits(mask, i, out);
+        }
+    }
+    bool tailOpen = scanScalar(text, i, out);
+    return hasOpen || tailOpen;
+}
+
+bool cpuSupportsAvx2() noexcept {
+#if defined(_MSC_VER)
+    int info[4]{};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false; // 操作系统未启用 YMM 寄存器状态保存
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // PA_SCANNER_X86
+
+DelimiterScanner::SimdLevel detectLevel() noexcept {
+#ifdef PA_SCANNER_X86
+    return cpuSupportsAvx2() ? DelimiterScanner::SimdLevel::AVX2 : DelimiterScanner::SimdLevel::SSE2;
+#else
+    return DelimiterScanner::SimdLevel::Scalar;
+#endif
+}
+
+} // namespace
+
+void StructuralIndex::build(std::string_view text) {
+    mPositions.clear();
+    mHasPlaceholderStart = DelimiterScanner::scan(text, mPositions);
+}
+
+namespace DelimiterScanner {
+
+SimdLevel activeLevel() noexcept {
+    static const SimdLevel level = detectLevel();
+    return level;
+}
+
+const char* levelName(SimdLevel level) noexcept {
+    switch (level) {
+    case SimdLevel::AVX2:
+        return "AVX2";
+    case SimdLevel::SSE2:
+        return "SSE2";
+    default:
+        return "Scalar";
+    }
+}
+
+bool scan(std::string_view text, std::vector<size_t>& out) { return scanWith(activeLevel(), text, out); }
+
+bool scanWith(SimdLevel level, std::string_view text, std::vector<size_t>& out) {
+    if (level > activeLevel()) {
+        level = activeLevel();
+    }
+#ifdef PA_SCANNER_X86
+    switch (level) {
+    case SimdLevel::AVX2:
+        return scanAvx2(text, out);
+    case SimdLevel::SSE2:
+        return scanSse2(text, out);
+    default:
+        break;
+    }
+#endif
+    return scanScalar(text, 0, out);
+}
+
+} // namespace DelimiterScanner
+
+} // namespace PA
@@ -0,0 +1,48 @@
+// src/PA/DelimiterScanner.h
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace PA {
+
+/**
+ * @brief 结构字符索引
+ * 一次扫描记录文本中全部 `{`、`}`、`%`、`\` 的位置；
+ * 占位符查找、括号匹配与转义跳过都只遍历该索引，不再逐字节扫描原文。
+ */
+class StructuralIndex {
+public:
+    void build(std::string_view text);
+
+    const std::vector<size_t>& positions() const noexcept { return mPositions; }
+    size_t                     size() const noexcept { return mPositions.size(); }
+    size_t                     operator[](size_t i) const noexcept { return mPositions[i]; }
+
+    // 是否包含可能的占位符起始字符（`%` 或 `{`）
+    bool hasPlaceholderStart() const noexcept { return mHasPlaceholderStart; }
+
+private:
+    std::vector<size_t> mPositions;
+    bool                mHasPlaceholderStart{};
+};
+
+namespace DelimiterScanner {
+
+enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+// 当前 CPU 可用的最高指令集（首次调用时检测）
+SimdLevel activeLevel() noexcept;
+
+const char* levelName(SimdLevel level) noexcept;
+
+// 以当前指令集扫描，追加结构字符位置到 out；返回是否出现 `%` 或 `{`
+bool scan(std::string_view text, std::vector<size_t>& out);
+
+// 以指定指令集扫描（CPU 不支持时退回可用的最高级别），供基准测试与对拍使用
+bool scanWith(SimdLevel level, std::string_view text, std::vector<size_t>& out);
+
+} // namespace DelimiterScanner
+
+} // namespace PA
@@ -5,7 +5,14 @@
 #include "PA/PlaceholderAPI.h"
 
 #include "PA/ScriptExports.h" // 脚本导出
+#include "ll/api/event/EventBus.h"
+#include "ll/api/event/player/PlayerDisconnectEvent.h"
 #include "ll/api/mod/RegisterHelper.h"
+#include "ll/api/thread/ServerThreadExecutor.h"
+
+#ifdef PA_SELF_TEST
+#include "SelfTest.h"
+#endif
 
 
 
@@ -29,13 +36,34 @@ bool Entry::load() {
 bool Entry::enable() {
     getSelf().getLogger().debug("Enabling...");
     // Code for enabling the mod goes here.
+    // 缓存的后台刷新放到服务器主线程执行：内置占位符会访问 Level 等只能在主线程读取的对象
+    PA_GetPlaceholderService()->setCacheExecutor([](std::function<void()> task) {
+        ll::thread::ServerThreadExecutor::getDefault().execute(std::move(task));
+    });
     registerAllBuiltinPlaceholders(PA_GetPlaceholderService());
 
+#ifdef PA_SELF_TEST
+    SelfTest::runAll();
+#endif
+
+    // 玩家对象随后会被销毁，其地址可能被新实体复用，离开时立即移除以它为 key 的缓存值
+    mPlayerDisconnectListener = ll::event::EventBus::getInstance().emplaceListener<ll::event::PlayerDisconnectEvent>(
+        [](ll::event::PlayerDisconnectEvent& event) {
+            auto ctx = PlayerContext::from(&event.self());
+            PA_GetPlaceholderService()->invalidateInstance(ctx.instanceId());
+        }
+    );
+
     return true;
 }
 
 bool Entry::disable() {
     getSelf().getLogger().debug("Disabling...");
+    if (mPlayerDisconnectListener) {
+        ll::event::EventBus::getInstance().removeListener(mPlayerDisconnectListener);
+        mPlayerDisconnectListener.reset();
+    }
+    PA_GetPlaceholderService()->setCacheExecutor(nullptr);
 
     return true;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ll/api/event/ListenerBase.h"
 #include "ll/api/mod/NativeMod.h"
 
 namespace PA {
@@ -23,7 +24,8 @@ class Entry {
     bool disable();
 
 private:
-    ll::mod::NativeMod& mSelf;
+    ll::mod::NativeMod&    mSelf;
+    ll::event::ListenerPtr mPlayerDisconnectListener; // 玩家离开时失效其缓存值
 };
 
 } // namespace PA
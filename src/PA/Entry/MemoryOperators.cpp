@@ -1,6 +1,93 @@
 // This file will make your mod use LeviLamina's memory operators by default.
 // This improves the memory management of your mod and is recommended to use.
 
+#ifndef PA_SELF_TEST
+
 #define LL_MEMORY_OPERATORS
 
 #include "ll/api/memory/MemoryOperators.h" // IWYU pragma: keep
+
+#else
+
+// 自检构建改用计数的 operator new/delete，供零分配测试统计当前线程的堆分配次数
+#include "SelfTest.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local uint64_t tAllocations = 0;
+
+void* allocate(std::size_t size) {
+    ++tAllocations;
+    return std::malloc(size ? size : 1);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t align) {
+    ++tAllocations;
+    size_t alignment = static_cast<size_t>(align);
+#ifdef _MSC_VER
+    return _aligned_malloc(size ? size : 1, alignment);
+#else
+    return std::aligned_alloc(alignment, ((size ? size : 1) + alignment - 1) / alignment * alignment);
+#endif
+}
+
+void releaseAligned(void* p) noexcept {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* allocateOrThrow(std::size_t size) {
+    if (void* p = allocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* allocateAlignedOrThrow(std::size_t size, std::align_val_t align) {
+    if (void* p = allocateAligned(size, align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+namespace PA::SelfTest {
+
+uint64_t threadAllocations() noexcept { return tAllocations; }
+
+} // namespace PA::SelfTest
+
+void* operator new(std::size_t size) { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return allocateAlignedOrThrow(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return allocateAlignedOrThrow(size, align); }
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, align);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { releaseAligned(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { releaseAligned(p); }
+
+#endif
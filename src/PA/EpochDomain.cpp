@@ -0,0 +1,99 @@
+// src/PA/EpochDomain.cpp
+#include "PA/EpochDomain.h"
+
+#include <algorithm>
+
+namespace PA {
+
+EpochDomain& EpochDomain::global() {
+    // 有意不析构：其他静态对象与线程退出时仍可能访问
+    static EpochDomain* domain = new EpochDomain();
+    return *domain;
+}
+
+EpochDomain::ThreadRecord* EpochDomain::localRecord() {
+    struct Holder {
+        ThreadRecord* record = global().acquireRecord();
+        ~Holder() { record->inUse.store(false, std::memory_order_release); }
+    };
+    thread_local Holder holder;
+    return holder.record;
+}
+
+EpochDomain::ThreadRecord* EpochDomain::acquireRecord() {
+    for (ThreadRecord* record = mRecords.load(std::memory_order_acquire); record; record = record->next) {
+        bool expected = false;
+        if (!record->inUse.load(std::memory_order_relaxed)
+            && record->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            return record;
+        }
+    }
+
+    auto* record = new ThreadRecord();
+    record->inUse.store(true, std::memory_order_relaxed);
+    record->next = mRecords.load(std::memory_order_relaxed);
+    while (!mRecords.compare_exchange_weak(record->next, record, std::memory_order_acq_rel)) {}
+    return record;
+}
+
+void EpochDomain::retire(std::function<void()> reclaim) {
+    // 之后进入临界区的读者登记的 epoch 更大，不可能再看到该对象
+    const uint64_t epoch = mEpoch.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(mRetiredMutex);
+        mRetired.push_back({epoch, std::move(reclaim)});
+        if (epoch > mNewestRetired.load(std::memory_order_relaxed)) {
+            mNewestRetired.store(epoch, std::memory_order_seq_cst);
+        }
+    }
+    collect();
+}
+
+size_t EpochDomain::collect() {
+    uint64_t oldestActive = UINT64_MAX;
+    for (ThreadRecord* record = mRecords.load(std::memory_order_acquire); record; record = record->next) {
+        const uint64_t epoch = record->epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0) {
+            oldestActive = std::min(oldestActive, epoch);
+        }
+    }
+
+    std::vector<std::function<void()>> ready;
+    size_t                             remaining = 0;
+    {
+        std::lock_guard<std::mutex> lock(mRetiredMutex);
+        auto split = std::partition(mRetired.begin(), mRetired.end(), [oldestActive](const Retired& retired) {
+            return retired.epoch >= oldestActive;
+        });
+        for (auto it = split; it != mRetired.end(); ++it) {
+            ready.push_back(std::move(it->reclaim));
+        }
+        mRetired.erase(split, mRetired.end());
+        remaining = mRetired.size();
+
+        uint64_t newest = 0;
+        for (const auto& retired : mRetired) {
+            newest = std::max(newest, retired.epoch);
+        }
+        mNewestRetired.store(newest, std::memory_order_seq_cst);
+    }
+
+    // 在锁外回收，reclaim 中析构的对象可以再次调用 retire()
+    for (auto& reclaim : ready) {
+        reclaim();
+    }
+    return remaining;
+}
+
+void EpochDomain::tryCollect() {
+    // 先登记请求再争抢回收权：正在回收的线程释放回收权后会看到请求并再回收一轮，请求不会丢失
+    mCollectRequested.store(true, std::memory_order_seq_cst);
+    while (mCollectRequested.load(std::memory_order_seq_cst)
+           && !mCollecting.exchange(true, std::memory_order_acquire)) {
+        mCollectRequested.store(false, std::memory_order_seq_cst);
+        collect();
+        mCollecting.store(false, std::memory_order_seq_cst);
+    }
+}
+
+} // namespace PA
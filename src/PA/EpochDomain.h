@@ -0,0 +1,95 @@
+// src/PA/EpochDomain.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace PA {
+
+/**
+ * @brief 基于 epoch 的延迟回收（RCU 风格）
+ * 读者进入临界区时在线程私有记录上登记当前全局 epoch，离开时清除；
+ * 写者把已摘除、不再对新读者可见的对象交给 retire()，待所有可能看到它的读者离开后才真正回收。
+ * 读者路径只写自己的记录，不触碰任何共享引用计数。
+ * retire() 时仍被读者阻挡的对象，由最后一个可能看到它的读者在离开最外层临界区时回收，
+ * 因此最后一次发布之后旧对象同样会被释放，reclaim 可能在读者线程上执行。
+ */
+class EpochDomain {
+    struct ThreadRecord;
+
+public:
+    // 读临界区，同一线程上可嵌套；必须在创建它的线程上析构
+    class Guard {
+    public:
+        Guard() : mRecord(localRecord()) {
+            if (mRecord->depth++ == 0) {
+                mRecord->epoch.store(global().mEpoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+            }
+        }
+        ~Guard() {
+            if (--mRecord->depth == 0) {
+                const uint64_t entered = mRecord->epoch.load(std::memory_order_relaxed);
+                mRecord->epoch.store(0, std::memory_order_seq_cst);
+                // 进入时已有待回收对象的 epoch 不小于 entered，说明本读者可能正阻挡它们
+                EpochDomain& domain = global();
+                if (entered <= domain.mNewestRetired.load(std::memory_order_seq_cst)) {
+                    domain.tryCollect();
+                }
+            }
+        }
+
+        Guard(const Guard&)            = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        ThreadRecord* mRecord;
+    };
+
+    static EpochDomain& global();
+
+    /**
+     * @brief 登记待回收对象
+     * 调用前对象必须已从共享结构中摘除（新读者不可能再看到它）；reclaim 在当前所有读者离开后执行
+     */
+    void retire(std::function<void()> reclaim);
+
+    // 执行已可安全回收的 reclaim，返回仍在等待的数量
+    size_t collect();
+
+    // 读者离开时调用：已有线程在回收时只留下标记，由该线程在结束前再回收一轮，不在读者路径上等待
+    void tryCollect();
+
+private:
+    struct ThreadRecord {
+        std::atomic<uint64_t> epoch{0}; // 0 表示不在临界区
+        std::atomic<bool>     inUse{false};
+        uint32_t              depth{};  // 嵌套深度，仅所属线程访问
+        ThreadRecord*         next{};
+    };
+
+    struct Retired {
+        uint64_t              epoch{};
+        std::function<void()> reclaim;
+    };
+
+    EpochDomain() = default;
+
+    // 当前线程的记录；线程退出时归还，供之后的线程复用
+    static ThreadRecord* localRecord();
+    ThreadRecord*        acquireRecord();
+
+    std::atomic<uint64_t>      mEpoch{1};
+    std::atomic<ThreadRecord*> mRecords{nullptr}; // 只增不减的记录链表
+
+    std::mutex            mRetiredMutex;
+    std::vector<Retired>  mRetired;
+    std::atomic<uint64_t> mNewestRetired{0}; // 待回收对象中最大的 epoch，0 表示没有；在 mRetiredMutex 内更新
+    std::atomic<bool>     mCollecting{false};
+    std::atomic<bool>     mCollectRequested{false};
+};
+
+} // namespace PA
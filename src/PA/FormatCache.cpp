@@ -0,0 +1,42 @@
+// src/PA/FormatCache.cpp
+#include "PA/FormatCache.h"
+
+namespace PA {
+
+FormatCache::FormatCache(size_t capacity) : mCache(capacity) {}
+
+FormatCache& FormatCache::global() {
+    static FormatCache instance;
+    return instance;
+}
+
+FormatCache::ParamsHandle FormatCache::parse(std::string_view spec) {
+    return std::make_shared<const ParameterParser::PlaceholderParams>(ParameterParser::parse(spec));
+}
+
+FormatCache::ParamsHandle FormatCache::acquire(std::string_view spec) {
+    if (mCache.capacity() == 0 || spec.length() > kMaxSpecLength) {
+        return parse(spec);
+    }
+
+    const uint64_t key = fnv1a64_constexpr(spec.data(), spec.size());
+    if (auto cached = mCache.get(key)) {
+        // 哈希碰撞时按未命中处理，新解析结果会覆盖旧条目
+        if (*cached && (*cached)->spec == spec) {
+            return ParamsHandle(*cached, &(*cached)->params);
+        }
+    }
+
+    auto entry = std::make_shared<const Entry>(Entry{std::string(spec), ParameterParser::parse(spec)});
+    mCache.put(key, entry);
+    return ParamsHandle(entry, &entry->params);
+}
+
+void FormatCache::setCapacity(size_t capacity) { mCache.setCapacity(capacity); }
+
+void FormatCache::clear() {
+    mCache.clear();
+    mGeneration.fetch_add(1, std::memory_order_acq_rel);
+}
+
+} // namespace PA
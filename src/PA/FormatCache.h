@@ -0,0 +1,61 @@
+// src/PA/FormatCache.h
+#pragma once
+
+#include "PA/ParameterParser.h"
+#include "PA/ShardedLruCache.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace PA {
+
+/**
+ * @brief 格式化参数的解析结果缓存
+ * key 为格式化参数原文（formatting_param_part）的哈希，值为完整解析后的 PlaceholderParams：
+ * 正则已编译、JSON 已解析、条件列表与颜色阈值已拆分。同一格式化参数反复渲染时不再做任何解析；
+ * 解析结果创建后不再修改，可在多个线程间共享。
+ */
+class FormatCache {
+public:
+    using ParamsHandle = std::shared_ptr<const ParameterParser::PlaceholderParams>;
+
+    static constexpr size_t kDefaultCapacity = 1024;
+
+    explicit FormatCache(size_t capacity = kDefaultCapacity);
+
+    static FormatCache& global();
+
+    // 获取（必要时解析）格式化参数；容量为 0 或参数过长时每次都重新解析
+    ParamsHandle acquire(std::string_view spec);
+
+    void setCapacity(size_t capacity);
+
+    // 丢弃全部解析结果并递增代数；正则引擎等解析设置变化后调用
+    void clear();
+
+    // 解析结果的代数：持有 acquire() 结果的一方（如模板绑定）据此判断结果是否仍按当前设置解析
+    uint64_t generation() const noexcept { return mGeneration.load(std::memory_order_acquire); }
+
+private:
+    struct Entry {
+        std::string                        spec;
+        ParameterParser::PlaceholderParams params;
+    };
+
+    struct KeyHash {
+        size_t operator()(uint64_t key) const noexcept { return static_cast<size_t>(key ^ (key >> 32)); }
+    };
+
+    // 超过该长度的格式化参数不缓存，避免巨大的 json_map 占满缓存
+    static constexpr size_t kMaxSpecLength = 4096;
+
+    static ParamsHandle parse(std::string_view spec);
+
+    ShardedLruCache<uint64_t, std::shared_ptr<const Entry>, KeyHash> mCache;
+    std::atomic<uint64_t>                                            mGeneration{0};
+};
+
+} // namespace PA
@@ -63,7 +63,7 @@ uint64_t parseContextKind(std::string kind) {
 
 // ========== JsPlaceholder 类 ==========
 
-class JsPlaceholder final : public IPlaceholder {
+class JsPlaceholder final : public IExtendedPlaceholder {
 public:
     JsPlaceholder(
         std::string  tokenNameNoBraces,
@@ -82,6 +82,8 @@ class JsPlaceholder final : public IPlaceholder {
     std::string_view token() const noexcept override { return mTokenBraced; }
     uint64_t         contextTypeId() const noexcept override { return mCtxId; }
     unsigned int     getCacheDuration() const noexcept override { return mCacheDuration; }
+    // 每次求值都是一次 RemoteCall 往返，并发未命中时只让一个线程调用脚本
+    uint32_t         getCacheFlags() const noexcept override { return kCacheSingleFlight; }
 
     void evaluate(const IContext* ctx, std::string& out) const override {
         evaluateWithArgs(ctx, {}, out);
@@ -0,0 +1,970 @@
+// src/PA/LinearRegex.cpp
+#include "PA/LinearRegex.h"
+
+#include <algorithm>
+
+namespace PA {
+
+namespace {
+
+constexpr size_t kNoPos           = std::string_view::npos;
+constexpr int    kMaxNestingDepth = 128;     // 分组嵌套上限，防止解析与生成代码时栈过深
+constexpr size_t kMaxProgramSize  = 1 << 15; // 展开计数量词后的指令数上限
+constexpr int    kMaxRepeatCount  = 1000;    // {n,m} 中单个界限的上限
+constexpr int    kMaxEmptyChecks  = 3;       // 需要检查空迭代的量词的嵌套层数上限，每层使线程状态数翻倍
+
+bool isWordChar(unsigned char c) noexcept {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+} // namespace
+
+// ---------------- 编译 ----------------
+
+class LinearRegex::Compiler {
+public:
+    Compiler(std::string_view pattern, LinearRegex& out) : mPattern(pattern), mOut(out) {}
+
+    bool run() {
+        int root = parseAlternation(0);
+        if (mFailed || mPos != mPattern.size()) {
+            return false;
+        }
+        mOut.mGroups = static_cast<size_t>(mGroupCount) + 1;
+        emitInst({Op::Save, 0, 0, 0});
+        emit(root);
+        emitInst({Op::Save, 0, 1, 0});
+        emitInst({Op::Match, 0, 0, 0});
+        if (!mFailed && mGroupCount == 0) {
+            buildSimple(root);
+        }
+        return !mFailed;
+    }
+
+private:
+    enum class Kind { Empty, Char, Any, Class, Assert, Concat, Alternate, Group, Repeat };
+
+    struct Node {
+        Kind             kind{};
+        uint8_t          byte{};
+        uint32_t         index{};    // Class 下标或捕获组编号
+        bool             capturing{};
+        int              min{};
+        int              max{};      // -1 表示无上限
+        bool             greedy{true};
+        bool             checkEmpty{}; // 循环体可匹配空串：超出下限的迭代未消耗字符即失败
+        std::vector<int> children;
+    };
+
+    static Node makeNode(Kind kind, uint8_t byte = 0, uint32_t index = 0) {
+        Node node;
+        node.kind  = kind;
+        node.byte  = byte;
+        node.index = index;
+        return node;
+    }
+
+    int fail() {
+        mFailed = true;
+        return -1;
+    }
+
+    bool atEnd() const noexcept { return mPos >= mPattern.size(); }
+    char peek() const noexcept { return mPattern[mPos]; }
+
+    int addNode(Node node) {
+        mNodes.push_back(std::move(node));
+        return static_cast<int>(mNodes.size()) - 1;
+    }
+
+    int addClass(const ByteSet& set) {
+        mOut.mClasses.push_back(set);
+        return addNode(makeNode(Kind::Class, 0, static_cast<uint32_t>(mOut.mClasses.size() - 1)));
+    }
+
+    static void addByte(ByteSet& set, unsigned char c) noexcept { set[c >> 6] |= uint64_t{1} << (c & 63); }
+
+    static void addRange(ByteSet& set, unsigned char lo, unsigned char hi) noexcept {
+        for (unsigned c = lo; c <= hi; ++c) {
+            addByte(set, static_cast<unsigned char>(c));
+        }
+    }
+
+    static void negate(ByteSet& set) noexcept {
+        for (auto& word : set) {
+            word = ~word;
+        }
+    }
+
+    // \d \w \s 及其大写取反形式；不是类转义时返回 false
+    static bool classEscape(char c, ByteSet& set) {
+        ByteSet local{};
+        switch (c) {
+        case 'd':
+        case 'D':
+            addRange(local, '0', '9');
+            break;
+        case 'w':
+        case 'W':
+            addRange(local, '0', '9');
+            addRange(local, 'a', 'z');
+            addRange(local, 'A', 'Z');
+            addByte(local, '_');
+            break;
+        case 's':
+        case 'S':
+            for (unsigned char ws : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+                addByte(local, ws);
+            }
+            break;
+        default:
+            return false;
+        }
+        if (c == 'D' || c == 'W' || c == 'S') {
+            negate(local);
+        }
+        for (size_t i = 0; i < set.size(); ++i) {
+            set[i] |= local[i];
+        }
+        return true;
+    }
+
+    static int hexValue(char c) noexcept {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    bool parseHex(size_t digits, unsigned& value) {
+        if (mPos + digits > mPattern.size()) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < digits; ++i) {
+            int v = hexValue(mPattern[mPos + i]);
+            if (v < 0) {
+                return false;
+            }
+            value = value * 16 + static_cast<unsigned>(v);
+        }
+        mPos += digits;
+        return true;
+    }
+
+    // 解析 '\' 之后表示单个字符的转义；inClass 时 \b 表示退格
+    bool characterEscape(char c, bool inClass, unsigned char& out) {
+        switch (c) {
+        case 'n':
+            out = '\n';
+            return true;
+        case 'r':
+            out = '\r';
+            return true;
+        case 't':
+            out = '\t';
+            return true;
+        case 'f':
+            out = '\f';
+            return true;
+        case 'v':
+            out = '\v';
+            return true;
+        case '0':
+            out = '\0';
+            return true;
+        case 'b':
+            if (!inClass) return false;
+            out = '\b';
+            return true;
+        case 'x':
+        case 'u': {
+            unsigned value = 0;
+            if (!parseHex(c == 'x' ? 2 : 4, value) || value > 0xFF) {
+                return false; // 按字节匹配，超出单字节的码点不受支持
+            }
+            out = static_cast<unsigned char>(value);
+            return true;
+        }
+        default:
+            // 反向引用、\c 控制字符以及字母数字的未知转义交给 std::regex 处理或报错
+            if (isWordChar(static_cast<unsigned char>(c))) {
+                return false;
+            }
+            out = static_cast<unsigned char>(c);
+            return true;
+        }
+    }
+
+    bool nullable(int index) const {
+        const Node& node = mNodes[index];
+        switch (node.kind) {
+        case Kind::Char:
+        case Kind::Any:
+        case Kind::Class:
+            return false;
+        case Kind::Concat:
+            return std::all_of(node.children.begin(), node.children.end(), [this](int c) { return nullable(c); });
+        case Kind::Alternate:
+            return std::any_of(node.children.begin(), node.children.end(), [this](int c) { return nullable(c); });
+        case Kind::Group:
+            return nullable(node.children.front());
+        case Kind::Repeat:
+            return node.min == 0 || nullable(node.children.front());
+        default:
+            return true;
+        }
+    }
+
+    int parseAlternation(int depth) {
+        if (depth > kMaxNestingDepth) {
+            return fail();
+        }
+        std::vector<int> branches{parseConcatenation(depth)};
+        while (!mFailed && !atEnd() && peek() == '|') {
+            ++mPos;
+            branches.push_back(parseConcatenation(depth));
+        }
+        if (mFailed) {
+            return -1;
+        }
+        if (branches.size() == 1) {
+            return branches.front();
+        }
+        Node node = makeNode(Kind::Alternate);
+        node.children = std::move(branches);
+        return addNode(std::move(node));
+    }
+
+    int parseConcatenation(int depth) {
+        Node node = makeNode(Kind::Concat);
+        while (!mFailed && !atEnd() && peek() != '|' && peek() != ')') {
+            node.children.push_back(parseRepeat(depth));
+        }
+        if (mFailed) {
+            return -1;
+        }
+        if (node.children.empty()) {
+            return addNode(makeNode(Kind::Empty));
+        }
+        if (node.children.size() == 1) {
+            return node.children.front();
+        }
+        return addNode(std::move(node));
+    }
+
+    bool parseBound(int& value) {
+        size_t start = mPos;
+        value        = 0;
+        while (!atEnd() && peek() >= '0' && peek() <= '9') {
+            value = value * 10 + (peek() - '0');
+            if (value > kMaxRepeatCount) {
+                return false;
+            }
+            ++mPos;
+        }
+        return mPos != start;
+    }
+
+    int parseRepeat(int depth) {
+        int atom = parseAtom(depth);
+        if (mFailed) {
+            return -1;
+        }
+        while (!atEnd()) {
+            int  min = 0;
+            int  max = -1;
+            char c   = peek();
+            if (c == '*') {
+                ++mPos;
+            } else if (c == '+') {
+                min = 1;
+                ++mPos;
+            } else if (c == '?') {
+                max = 1;
+                ++mPos;
+            } else if (c == '{') {
+                ++mPos;
+                if (!parseBound(min)) {
+                    return fail();
+                }
+                max = min;
+                if (!atEnd() && peek() == ',') {
+                    ++mPos;
+                    max = -1;
+                    if (!atEnd() && peek() != '}' && (!parseBound(max) || max < min)) {
+                        return fail();
+                    }
+                }
+                if (atEnd() || peek() != '}') {
+                    return fail();
+                }
+                ++mPos;
+            } else {
+                break;
+            }
+            // 断言不可被量词修饰，与 ECMAScript 一致视为语法错误
+            if (mNodes[atom].kind == Kind::Assert) {
+                return fail();
+            }
+            bool greedy = true;
+            if (!atEnd() && peek() == '?') {
+                greedy = false;
+                ++mPos;
+            }
+            Node node = makeNode(Kind::Repeat);
+            node.min    = min;
+            node.max    = max;
+            node.greedy     = greedy;
+            node.checkEmpty = max != min && nullable(atom);
+            node.children.push_back(atom);
+            atom = addNode(std::move(node));
+        }
+        return atom;
+    }
+
+    int parseClass() {
+        ByteSet set{};
+        bool    negated = false;
+        if (!atEnd() && peek() == '^') {
+            negated = true;
+            ++mPos;
+        }
+        while (true) {
+            if (atEnd()) {
+                return fail();
+            }
+            char c = mPattern[mPos++];
+            if (c == ']') {
+                break;
+            }
+
+            unsigned char lo = 0;
+            if (c == '\\') {
+                if (atEnd()) {
+                    return fail();
+                }
+                char e = mPattern[mPos++];
+                if (classEscape(e, set)) {
+                    // 类转义不能作为范围端点
+                    if (!atEnd() && peek() == '-' && mPos + 1 < mPattern.size() && mPattern[mPos + 1] != ']') {
+                        return fail();
+                    }
+                    continue;
+                }
+                if (!characterEscape(e, true, lo)) {
+                    return fail();
+                }
+            } else {
+                lo = static_cast<unsigned char>(c);
+            }
+
+            if (!atEnd() && peek() == '-' && mPos + 1 < mPattern.size() && mPattern[mPos + 1] != ']') {
+                ++mPos;
+                char          h  = mPattern[mPos++];
+                unsigned char hi = static_cast<unsigned char>(h);
+                if (h == '\\') {
+                    if (atEnd()) {
+                        return fail();
+                    }
+                    char e = mPattern[mPos++];
+                    if (!characterEscape(e, true, hi)) {
+                        return fail();
+                    }
+                }
+                if (hi < lo) {
+                    return fail();
+                }
+                addRange(set, lo, hi);
+            } else {
+                addByte(set, lo);
+            }
+        }
+        if (negated) {
+            negate(set);
+        }
+        return addClass(set);
+    }
+
+    int parseAtom(int depth) {
+        char c = mPattern[mPos++];
+        switch (c) {
+        case '.':
+            return addNode(makeNode(Kind::Any));
+        case '^':
+            return addNode(makeNode(Kind::Assert, static_cast<uint8_t>(AssertKind::LineBegin)));
+        case '$':
+            return addNode(makeNode(Kind::Assert, static_cast<uint8_t>(AssertKind::LineEnd)));
+        case '[':
+            return parseClass();
+        case '(': {
+            Node node = makeNode(Kind::Group);
+            if (!atEnd() && peek() == '?') {
+                // 只支持 (?:...)；前瞻等需要回溯的语法交给 std::regex
+                if (mPos + 1 >= mPattern.size() || mPattern[mPos + 1] != ':') {
+                    return fail();
+                }
+                mPos += 2;
+            } else {
+                node.capturing = true;
+                node.index     = static_cast<uint32_t>(++mGroupCount);
+            }
+            int inner = parseAlternation(depth + 1);
+            if (mFailed || atEnd() || peek() != ')') {
+                return fail();
+            }
+            ++mPos;
+            node.children.push_back(inner);
+            return addNode(std::move(node));
+        }
+        case ')':
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            return fail(); // 没有可重复的内容，或括号不配对
+        case '\\': {
+            if (atEnd()) {
+                return fail();
+            }
+            char e = mPattern[mPos++];
+            if (e == 'b' || e == 'B') {
+                auto kind = e == 'b' ? AssertKind::WordBoundary : AssertKind::NotWordBoundary;
+                return addNode(makeNode(Kind::Assert, static_cast<uint8_t>(kind)));
+            }
+            ByteSet set{};
+            if (classEscape(e, set)) {
+                return addClass(set);
+            }
+            unsigned char byte = 0;
+            if (!characterEscape(e, false, byte)) {
+                return fail();
+            }
+            return addNode(makeNode(Kind::Char, byte));
+        }
+        default:
+            return addNode(makeNode(Kind::Char, static_cast<uint8_t>(c)));
+        }
+    }
+
+    // 单个字节集合元素（字符、`.`、字符类）在 mClasses 中的下标；其他节点返回 false
+    bool simpleSet(int index, uint32_t& set) {
+        const Node& node = mNodes[index];
+        ByteSet     bytes{};
+        switch (node.kind) {
+        case Kind::Class:
+            set = node.index;
+            return true;
+        case Kind::Char:
+            addByte(bytes, node.byte);
+            break;
+        case Kind::Any:
+            negate(bytes);
+            bytes[0] &= ~((uint64_t{1} << '\n') | (uint64_t{1} << '\r'));
+            break;
+        default:
+            return false;
+        }
+        mOut.mClasses.push_back(bytes);
+        set = static_cast<uint32_t>(mOut.mClasses.size() - 1);
+        return true;
+    }
+
+    bool disjoint(uint32_t a, uint32_t b) const noexcept {
+        for (size_t i = 0; i < mOut.mClasses[a].size(); ++i) {
+            if (mOut.mClasses[a][i] & mOut.mClasses[b][i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool simpleBranch(int index, SimpleBranch& branch) {
+        const Node&      node = mNodes[index];
+        std::vector<int> items;
+        if (node.kind == Kind::Concat) {
+            items = node.children;
+        } else if (node.kind != Kind::Empty) {
+            items.push_back(index);
+        }
+        for (size_t i = 0; i < items.size(); ++i) {
+            const Node& item = mNodes[items[i]];
+            if (item.kind == Kind::Assert) {
+                const auto kind = static_cast<AssertKind>(item.byte);
+                if (kind == AssertKind::LineBegin && i == 0) {
+                    branch.lineBegin = true;
+                } else if (kind == AssertKind::LineEnd && i + 1 == items.size()) {
+                    branch.lineEnd = true;
+                } else {
+                    return false;
+                }
+                continue;
+            }
+            SimpleStep step;
+            if (item.kind == Kind::Repeat) {
+                if ((!item.greedy && item.max != item.min) || !simpleSet(item.children.front(), step.set)) {
+                    return false;
+                }
+                step.min = item.min;
+                step.max = item.max;
+            } else if (simpleSet(items[i], step.set)) {
+                step.min = 1;
+                step.max = 1;
+            } else {
+                return false;
+            }
+            branch.steps.push_back(step);
+        }
+        // 次数可变的元素吃满后，交还的字符都属于它自己的集合，不可能让后面不相交的必选元素匹配成功
+        for (size_t i = 0; i + 1 < branch.steps.size(); ++i) {
+            const SimpleStep& step = branch.steps[i];
+            const SimpleStep& next = branch.steps[i + 1];
+            if (step.max != step.min && (next.min == 0 || !disjoint(step.set, next.set))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void buildSimple(int root) {
+        const Node&               node = mNodes[root];
+        std::vector<SimpleBranch> branches;
+        for (int child : node.kind == Kind::Alternate ? node.children : std::vector<int>{root}) {
+            SimpleBranch branch;
+            if (!simpleBranch(child, branch)) {
+                return;
+            }
+            branches.push_back(std::move(branch));
+        }
+        mOut.mSimple = std::move(branches);
+    }
+
+    uint32_t here() const noexcept { return static_cast<uint32_t>(mOut.mProgram.size()); }
+
+    uint32_t emitInst(const Inst& inst) {
+        if (mOut.mProgram.size() >= kMaxProgramSize) {
+            mFailed = true;
+            return here();
+        }
+        mOut.mProgram.push_back(inst);
+        return here() - 1;
+    }
+
+    void patchSplit(uint32_t at, uint32_t preferred, uint32_t other) {
+        if (at < mOut.mProgram.size()) {
+            mOut.mProgram[at].x = preferred;
+            mOut.mProgram[at].y = other;
+        }
+    }
+
+    void emit(int index) {
+        if (mFailed) {
+            return;
+        }
+        const Node& node = mNodes[index];
+        switch (node.kind) {
+        case Kind::Empty:
+            break;
+        case Kind::Char:
+            emitInst({Op::Char, node.byte, 0, 0});
+            break;
+        case Kind::Any:
+            emitInst({Op::Any, 0, 0, 0});
+            break;
+        case Kind::Class:
+            emitInst({Op::Class, 0, node.index, 0});
+            break;
+        case Kind::Assert:
+            emitInst({Op::Assert, node.byte, 0, 0});
+            break;
+        case Kind::Concat:
+            for (int child : node.children) {
+                emit(child);
+            }
+            break;
+        case Kind::Alternate: {
+            std::vector<uint32_t> jumps;
+            for (size_t i = 0; i + 1 < node.children.size(); ++i) {
+                uint32_t split = emitInst({Op::Split, 0, 0, 0});
+                emit(node.children[i]);
+                jumps.push_back(emitInst({Op::Jmp, 0, 0, 0}));
+                patchSplit(split, split + 1, here());
+            }
+            emit(node.children.back());
+            for (uint32_t jump : jumps) {
+                if (jump < mOut.mProgram.size()) {
+                    mOut.mProgram[jump].x = here();
+                }
+            }
+            break;
+        }
+        case Kind::Group:
+            if (node.capturing) {
+                emitInst({Op::Save, 0, node.index * 2, 0});
+            }
+            emit(node.children.front());
+            if (node.capturing) {
+                emitInst({Op::Save, 0, node.index * 2 + 1, 0});
+            }
+            break;
+        case Kind::Repeat: {
+            int child = node.children.front();
+            for (int i = 0; i < node.min && !mFailed; ++i) {
+                emit(child);
+            }
+            // 超出下限的每次迭代：循环体可匹配空串时以 Enter/Progress 包围，按嵌套层数占用线程状态中的一位
+            const uint8_t level = static_cast<uint8_t>(mEmptyCheckDepth);
+            if (node.checkEmpty) {
+                if (++mEmptyCheckDepth > kMaxEmptyChecks) {
+                    mFailed = true;
+                    return;
+                }
+                mOut.mStateBits = std::max(mOut.mStateBits, static_cast<uint32_t>(mEmptyCheckDepth));
+            }
+            auto iteration = [&] {
+                if (node.checkEmpty) {
+                    emitInst({Op::Enter, level, 0, 0});
+                }
+                emit(child);
+                if (node.checkEmpty) {
+                    emitInst({Op::Progress, level, 0, 0});
+                }
+            };
+            if (node.max < 0) {
+                uint32_t loop = emitInst({Op::Split, 0, 0, 0});
+                iteration();
+                emitInst({Op::Jmp, 0, loop, 0});
+                node.greedy ? patchSplit(loop, loop + 1, here()) : patchSplit(loop, here(), loop + 1);
+            } else {
+                // x{n,m} 展开为 n 个 x 接 m-n 个嵌套的可选 x，每个可选分支失败时都直接跳到末尾
+                std::vector<uint32_t> splits;
+                for (int i = node.min; i < node.max && !mFailed; ++i) {
+                    splits.push_back(emitInst({Op::Split, 0, 0, 0}));
+                    iteration();
+                }
+                for (uint32_t split : splits) {
+                    node.greedy ? patchSplit(split, split + 1, here()) : patchSplit(split, here(), split + 1);
+                }
+            }
+            if (node.checkEmpty) {
+                --mEmptyCheckDepth;
+            }
+            break;
+        }
+        }
+    }
+
+    std::string_view  mPattern;
+    LinearRegex&      mOut;
+    size_t            mPos{};
+    bool              mFailed{};
+    int               mGroupCount{};
+    int               mEmptyCheckDepth{};
+    std::vector<Node> mNodes;
+};
+
+std::unique_ptr<const LinearRegex> LinearRegex::compile(std::string_view pattern) {
+    std::unique_ptr<LinearRegex> regex(new LinearRegex());
+    if (!Compiler(pattern, *regex).run()) {
+        return nullptr;
+    }
+    regex->computeFirstBytes();
+    return regex;
+}
+
+void LinearRegex::computeFirstBytes() {
+    ByteSet               first{};
+    std::vector<bool>     visited(mProgram.size());
+    std::vector<uint32_t> pending{0};
+    while (!pending.empty()) {
+        uint32_t pc = pending.back();
+        pending.pop_back();
+        if (visited[pc]) {
+            continue;
+        }
+        visited[pc]      = true;
+        const Inst& inst = mProgram[pc];
+        switch (inst.op) {
+        case Op::Char:
+            first[inst.byte >> 6] |= uint64_t{1} << (inst.byte & 63);
+            break;
+        case Op::Any:
+            first[0] |= ~((uint64_t{1} << '\n') | (uint64_t{1} << '\r'));
+            for (size_t i = 1; i < first.size(); ++i) {
+                first[i] = ~uint64_t{0};
+            }
+            break;
+        case Op::Class:
+            for (size_t i = 0; i < first.size(); ++i) {
+                first[i] |= mClasses[inst.x][i];
+            }
+            break;
+        case Op::Split:
+            pending.push_back(inst.x);
+            pending.push_back(inst.y);
+            break;
+        case Op::Jmp:
+            pending.push_back(inst.x);
+            break;
+        case Op::Save:
+        case Op::Enter:
+        case Op::Progress:
+            pending.push_back(pc + 1);
+            break;
+        case Op::Assert:
+        case Op::Match:
+            return;
+        }
+    }
+    mFirstBytes    = first;
+    mHasFirstBytes = true;
+}
+
+LinearRegex::~LinearRegex() = default;
+
+// ---------------- 匹配 ----------------
+
+void LinearRegex::Scratch::prepare(size_t stateCount, size_t programSize, size_t capCount) {
+    for (auto& list : lists) {
+        if (list.sparse.size() < stateCount) {
+            list.dense.resize(stateCount);
+            list.sparse.resize(stateCount);
+        }
+        if (list.caps.size() < programSize * capCount) {
+            list.caps.resize(programSize * capCount);
+        }
+        list.size = 0;
+    }
+    caps.resize(capCount);
+    stack.clear();
+}
+
+bool LinearRegex::holds(AssertKind kind, std::string_view input, size_t pos) const noexcept {
+    switch (kind) {
+    case AssertKind::LineBegin:
+        return pos == 0;
+    case AssertKind::LineEnd:
+        return pos == input.size();
+    case AssertKind::WordBoundary:
+    case AssertKind::NotWordBoundary: {
+        bool before   = pos > 0 && isWordChar(static_cast<unsigned char>(input[pos - 1]));
+        bool after    = pos < input.size() && isWordChar(static_cast<unsigned char>(input[pos]));
+        bool boundary = before != after;
+        return kind == AssertKind::WordBoundary ? boundary : !boundary;
+    }
+    }
+    return false;
+}
+
+void LinearRegex::addThread(
+    Scratch&             scratch,
+    Scratch::ThreadList& list,
+    uint32_t             pc,
+    std::string_view     input,
+    size_t               pos
+) const {
+    const size_t capCount = mGroups * 2;
+    auto&        stack    = scratch.stack;
+    auto&        caps     = scratch.caps;
+    stack.push_back({pc});
+
+    while (!stack.empty()) {
+        Scratch::Frame frame = stack.back();
+        stack.pop_back();
+        if (frame.restore) {
+            caps[frame.slot] = frame.saved;
+            continue;
+        }
+
+        uint32_t current = frame.pc;
+        uint32_t flags   = frame.flags;
+        while (true) {
+            const Inst& inst = mProgram[current];
+            if (inst.op == Op::Progress && ((flags >> inst.byte) & 1)) {
+                break; // 本次迭代没有消耗字符
+            }
+            // 消耗字符与 Match 的状态之后所有迭代都已前进，去重时不区分标志位
+            const bool     consumes = inst.op == Op::Char || inst.op == Op::Any || inst.op == Op::Class
+                               || inst.op == Op::Match;
+            const uint32_t state    = (current << mStateBits) | (consumes ? 0 : flags);
+            if (list.contains(state)) {
+                break;
+            }
+            list.sparse[state]      = static_cast<uint32_t>(list.size);
+            list.dense[list.size++] = state;
+
+            if (inst.op == Op::Jmp) {
+                current = inst.x;
+            } else if (inst.op == Op::Split) {
+                // 次要分支压栈，待优先分支完全展开后再处理，以保持回溯引擎的优先级
+                stack.push_back({inst.y, flags});
+                current = inst.x;
+            } else if (inst.op == Op::Save) {
+                stack.push_back({0, 0, inst.x, caps[inst.x], true});
+                caps[inst.x] = pos;
+                ++current;
+            } else if (inst.op == Op::Enter) {
+                // 新的一次迭代从当前位置开始；更内层的循环进入时会重新置位，先清掉它们的旧标志
+                flags = (flags & ((1u << inst.byte) - 1)) | (1u << inst.byte);
+                ++current;
+            } else if (inst.op == Op::Progress) {
+                ++current;
+            } else if (inst.op == Op::Assert) {
+                if (!holds(static_cast<AssertKind>(inst.byte), input, pos)) {
+                    break;
+                }
+                ++current;
+            } else {
+                // 消耗字符或 Match 的状态才需要记录子匹配位置
+                std::copy(caps.begin(), caps.end(), list.caps.begin() + current * capCount);
+                break;
+            }
+        }
+    }
+}
+
+bool LinearRegex::matchSimple(
+    const SimpleBranch& branch,
+    std::string_view    input,
+    size_t              start,
+    size_t&             end
+) const noexcept {
+    if (branch.lineBegin && start != 0) {
+        return false;
+    }
+    size_t pos = start;
+    for (const SimpleStep& step : branch.steps) {
+        const ByteSet& set   = mClasses[step.set];
+        const size_t   limit = step.max < 0 ? input.size() : std::min(input.size(), pos + step.max);
+        const size_t   begin = pos;
+        while (pos < limit && contains(set, static_cast<unsigned char>(input[pos]))) {
+            ++pos;
+        }
+        if (pos - begin < static_cast<size_t>(step.min)) {
+            return false;
+        }
+    }
+    if (branch.lineEnd && pos != input.size()) {
+        return false;
+    }
+    end = pos;
+    return true;
+}
+
+bool LinearRegex::searchSimple(
+    std::string_view   input,
+    size_t             from,
+    bool               notEmptyAtStart,
+    std::vector<Span>& groups
+) const {
+    const size_t last = notEmptyAtStart ? std::min(from, input.size()) : input.size();
+    for (size_t start = from; start <= last; ++start) {
+        if (mHasFirstBytes) {
+            while (start < input.size() && !contains(mFirstBytes, static_cast<unsigned char>(input[start]))) {
+                ++start;
+            }
+            if (start == input.size() || start > last) {
+                return false;
+            }
+        }
+        for (const SimpleBranch& branch : mSimple) {
+            size_t end = 0;
+            if (matchSimple(branch, input, start, end) && !(notEmptyAtStart && end == start)) {
+                groups.assign(1, Span{start, end});
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool LinearRegex::search(
+    std::string_view   input,
+    size_t             from,
+    bool               notEmptyAtStart,
+    std::vector<Span>& groups,
+    Scratch&           scratch
+) const {
+    if (!mSimple.empty()) {
+        return searchSimple(input, from, notEmptyAtStart, groups);
+    }
+    const size_t capCount = mGroups * 2;
+    scratch.prepare(mProgram.size() << mStateBits, mProgram.size(), capCount);
+
+    Scratch::ThreadList* current = &scratch.lists[0];
+    Scratch::ThreadList* next    = &scratch.lists[1];
+    bool                 matched = false;
+
+    for (size_t pos = from;; ++pos) {
+        // 没有存活线程时，直接跳到下一个可能开始匹配的位置
+        if (!matched && !notEmptyAtStart && current->size == 0 && mHasFirstBytes) {
+            while (pos < input.size() && !contains(mFirstBytes, static_cast<unsigned char>(input[pos]))) {
+                ++pos;
+            }
+            if (pos == input.size()) {
+                break;
+            }
+        }
+        // 还没找到匹配时，每个位置都以最低优先级开启一个新的起点（notEmptyAtStart 时只在 from 处开启）
+        if (!matched && (!notEmptyAtStart || pos == from)) {
+            std::fill(scratch.caps.begin(), scratch.caps.end(), kNoPos);
+            addThread(scratch, *current, 0, input, pos);
+        }
+        if (current->size == 0) {
+            break;
+        }
+
+        next->size = 0;
+        const bool          hasByte = pos < input.size();
+        const unsigned char c       = hasByte ? static_cast<unsigned char>(input[pos]) : 0;
+
+        for (size_t i = 0; i < current->size; ++i) {
+            const uint32_t pc   = current->dense[i] >> mStateBits;
+            const Inst&    inst = mProgram[pc];
+            const size_t*  caps = current->caps.data() + pc * capCount;
+
+            bool advance = false;
+            switch (inst.op) {
+            case Op::Char:
+                advance = hasByte && c == inst.byte;
+                break;
+            case Op::Any:
+                advance = hasByte && c != '\n' && c != '\r';
+                break;
+            case Op::Class:
+                advance = hasByte && contains(mClasses[inst.x], c);
+                break;
+            case Op::Match:
+                if (notEmptyAtStart && caps[1] == caps[0]) {
+                    continue;
+                }
+                groups.assign(mGroups, Span{});
+                for (size_t g = 0; g < mGroups; ++g) {
+                    if (caps[g * 2] != kNoPos && caps[g * 2 + 1] != kNoPos) {
+                        groups[g] = {caps[g * 2], caps[g * 2 + 1]};
+                    }
+                }
+                matched = true;
+                break;
+            default:
+                break;
+            }
+
+            if (inst.op == Op::Match && matched) {
+                break; // 低优先级的线程不再需要
+            }
+            if (advance) {
+                std::copy(caps, caps + capCount, scratch.caps.begin());
+                addThread(scratch, *next, pc + 1, input, pos + 1);
+            }
+        }
+
+        std::swap(current, next);
+        if (!hasByte) {
+            break;
+        }
+    }
+    return matched;
+}
+
+} // namespace PA
@@ -0,0 +1,140 @@
+// src/PA/LinearRegex.h
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace PA {
+
+/**
+ * @brief 线性时间的正则引擎（Thompson NFA / Pike VM）
+ * 支持 ECMAScript 语法中不需要回溯的子集：字面量、`.`、字符类与 \d\w\s 等转义、`^`/`$`/`\b`/`\B`、
+ * 捕获与非捕获分组、`|`、贪婪与非贪婪的 `* + ? {n,m}`。按字节匹配，与 std::regex 对 char 的语义一致。
+ * 匹配时所有候选状态同步推进，耗时与 文本长度 × 程序长度 成正比，不会因模式写法而指数回溯，也不使用递归。
+ * 子匹配按回溯引擎的优先级选取（最左、再按分支与量词的偏好），结果与 std::regex 相同。
+ * 循环体可匹配空串的量词（如 `(a*)*`）按 ECMAScript 的规则处理：超出下限的迭代没有消耗字符即告失败；
+ * 线程状态为 {程序计数器, 各层此类循环本次迭代是否已前进}，因此最多嵌套 3 层。
+ * 反向引用、前瞻等需要回溯的语法不支持，compile() 返回 nullptr，调用方应回退到 std::regex。
+ */
+class LinearRegex {
+public:
+    // 子匹配位置；未参与匹配的分组 begin 为 npos
+    struct Span {
+        size_t begin = std::string_view::npos;
+        size_t end   = std::string_view::npos;
+
+        bool matched() const noexcept { return begin != std::string_view::npos; }
+    };
+
+    // 匹配过程的工作区，可在同一线程的多次 search 间复用以避免分配
+    class Scratch {
+    private:
+        friend class LinearRegex;
+
+        // 以线程状态为元素的稀疏集合，dense 的顺序即线程优先级；caps 按 pc 存放各线程的子匹配位置
+        struct ThreadList {
+            std::vector<uint32_t> dense;
+            std::vector<uint32_t> sparse;
+            std::vector<size_t>   caps;
+            size_t                size{};
+
+            bool contains(uint32_t pc) const noexcept { return sparse[pc] < size && dense[sparse[pc]] == pc; }
+        };
+
+        struct Frame {
+            uint32_t pc{};
+            uint32_t flags{}; // 从 pc 继续展开时各层空迭代检查的标志位
+            uint32_t slot{};
+            size_t   saved{};
+            bool     restore{};
+        };
+
+        void prepare(size_t stateCount, size_t programSize, size_t capCount);
+
+        std::array<ThreadList, 2> lists;
+        std::vector<size_t>       caps; // 正在展开 ε 闭包的线程的子匹配位置
+        std::vector<Frame>        stack;
+    };
+
+    // 编译模式；语法不受支持、模式非法或程序过大时返回 nullptr
+    static std::unique_ptr<const LinearRegex> compile(std::string_view pattern);
+
+    // 分组数（含整体匹配的第 0 组）
+    size_t groupCount() const noexcept { return mGroups; }
+
+    /**
+     * @brief 从 from 开始查找第一个匹配
+     * @param notEmptyAtStart 为 true 时只接受从 from 开始的非空匹配（用于空匹配之后的继续查找）
+     * @param groups 输出各分组的位置，大小为 groupCount()
+     */
+    bool search(
+        std::string_view   input,
+        size_t             from,
+        bool               notEmptyAtStart,
+        std::vector<Span>& groups,
+        Scratch&           scratch
+    ) const;
+
+    ~LinearRegex();
+
+private:
+    // Enter 标记第 byte 层循环的一次迭代从当前位置开始；Progress 在该迭代没有消耗字符时淘汰线程
+    enum class Op : uint8_t { Char, Any, Class, Split, Jmp, Save, Enter, Progress, Assert, Match };
+    enum class AssertKind : uint8_t { LineBegin, LineEnd, WordBoundary, NotWordBoundary };
+
+    struct Inst {
+        Op       op{};
+        uint8_t  byte{}; // Char 的字符、Assert 的种类，或 Enter/Progress 的循环层数
+        uint32_t x{};    // Split 的优先分支 / Jmp 目标 / Save 槽位 / Class 下标
+        uint32_t y{};    // Split 的次要分支
+    };
+
+    using ByteSet = std::array<uint64_t, 4>;
+
+    // 快速路径中分支的一个元素：重复 min 到 max 次（-1 表示无上限）的字节集合
+    struct SimpleStep {
+        uint32_t set{}; // mClasses 下标
+        int      min{};
+        int      max{};
+    };
+
+    struct SimpleBranch {
+        bool                    lineBegin{};
+        bool                    lineEnd{};
+        std::vector<SimpleStep> steps;
+    };
+
+    class Compiler;
+
+    LinearRegex() = default;
+
+    static bool contains(const ByteSet& set, unsigned char c) noexcept { return (set[c >> 6] >> (c & 63)) & 1; }
+    bool        holds(AssertKind kind, std::string_view input, size_t pos) const noexcept;
+
+    // 把 pc 及其经 ε 转移可达的状态按优先级加入线程表；用显式栈代替递归
+    void addThread(Scratch& scratch, Scratch::ThreadList& list, uint32_t pc, std::string_view input, size_t pos) const;
+
+    // 统计匹配可能的首字节；模式可匹配空串或以断言开头时不做预筛
+    void computeFirstBytes();
+
+    // 快速路径：分支从 start 起的匹配，成功时写入 end
+    bool matchSimple(const SimpleBranch& branch, std::string_view input, size_t start, size_t& end) const noexcept;
+    bool searchSimple(std::string_view input, size_t from, bool notEmptyAtStart, std::vector<Span>& groups) const;
+
+    std::vector<Inst>    mProgram;
+    std::vector<ByteSet> mClasses;
+    size_t               mGroups{};
+    uint32_t             mStateBits{}; // 线程状态中空迭代检查所占的位数，即此类循环的最大嵌套层数
+    ByteSet              mFirstBytes{};
+    bool                 mHasFirstBytes{};
+
+    // 颜色代码、空白清理等常见模式的快速路径，为空时使用 Pike VM。条件：没有捕获分组，各分支是字节集合的序列，
+    // 只在开头有 `^`、末尾有 `$`，次数可变的元素都是贪婪的，且位于分支末尾或其后紧跟与它不相交的必选元素。
+    // 此时贪婪地吃满不会错过回溯引擎的结果，按起点、再按分支顺序逐个尝试即可
+    std::vector<SimpleBranch> mSimple;
+};
+
+} // namespace PA
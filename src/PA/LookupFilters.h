@@ -0,0 +1,106 @@
+// src/PA/LookupFilters.h
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PA {
+
+/**
+ * @brief 只增不删的布隆过滤器，用于在查表前快速排除不可能命中的 token
+ * 每个元素约占 16 位、4 个探测位，假阳性率约 0.25%；尚未分配或插入次数达到设计容量时 full() 为真，
+ * 由调用方按当前元素数重建。被删除元素的位不会清除，只会略微抬高假阳性率，不会产生假阴性。
+ */
+class BloomFilter {
+public:
+    // 清空并按预计元素数重新分配位数组
+    void reset(size_t expected) {
+        const size_t bits = std::bit_ceil(std::max<size_t>(expected, 4) * kBitsPerElement);
+        mWords.assign(bits / 64, 0);
+        mMask       = bits - 1;
+        mCapacity   = std::max<size_t>(expected, 4);
+        mInsertions = 0;
+    }
+
+    bool full() const noexcept { return mInsertions >= mCapacity; }
+
+    void insert(uint64_t hash) noexcept {
+        if (mWords.empty()) {
+            return;
+        }
+        uint64_t       probe = mix(hash);
+        const uint64_t step  = (probe >> 32) | 1;
+        for (unsigned i = 0; i < kProbes; ++i, probe += step) {
+            mWords[(probe & mMask) >> 6] |= uint64_t{1} << (probe & 63);
+        }
+        ++mInsertions;
+    }
+
+    bool mayContain(uint64_t hash) const noexcept {
+        if (mWords.empty()) {
+            return false;
+        }
+        uint64_t       probe = mix(hash);
+        const uint64_t step  = (probe >> 32) | 1;
+        for (unsigned i = 0; i < kProbes; ++i, probe += step) {
+            if (!(mWords[(probe & mMask) >> 6] & (uint64_t{1} << (probe & 63)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr size_t   kBitsPerElement = 16;
+    static constexpr unsigned kProbes         = 4;
+
+    // FNV 等乘法哈希的低位分布较差，探测前再混合一次
+    static uint64_t mix(uint64_t h) noexcept {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    std::vector<uint64_t> mWords;
+    uint64_t              mMask{};
+    size_t                mCapacity{};
+    size_t                mInsertions{};
+};
+
+/**
+ * @brief 最近未命中查询的直接映射缓存
+ * 只保存 64 位指纹，槽位冲突时直接覆盖；读写均为单次 relaxed 原子操作，可被任意线程并发使用。
+ * 复制得到的是空缓存：以旧表为基础构建的新表不应继承旧的否定结果。
+ */
+class NegativeLookupCache {
+public:
+    NegativeLookupCache() = default;
+    NegativeLookupCache(const NegativeLookupCache& /* other */) noexcept {}
+    NegativeLookupCache& operator=(const NegativeLookupCache&) = delete;
+
+    bool contains(uint64_t fingerprint) const noexcept {
+        fingerprint = normalize(fingerprint);
+        return mSlots[fingerprint & (kSlots - 1)].load(std::memory_order_relaxed) == fingerprint;
+    }
+
+    void insert(uint64_t fingerprint) noexcept {
+        fingerprint = normalize(fingerprint);
+        mSlots[fingerprint & (kSlots - 1)].store(fingerprint, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t kSlots = 256;
+
+    // 0 表示空槽
+    static uint64_t normalize(uint64_t fingerprint) noexcept { return fingerprint ? fingerprint : 1; }
+
+    std::array<std::atomic<uint64_t>, kSlots> mSlots{};
+};
+
+} // namespace PA
@@ -0,0 +1,145 @@
+// src/PA/MathExpression.cpp
+#include "PA/MathExpression.h"
+#include "PA/PlaceholderAPI.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+#include <exprtk.hpp>
+
+namespace PA {
+
+namespace {
+
+using SymbolTable = exprtk::symbol_table<double>;
+using Expression  = exprtk::expression<double>;
+using Parser      = exprtk::parser<double>;
+
+std::string variableName(size_t index) { return "pa_var_" + std::to_string(index); }
+
+// 把顶层的 {占位符} 替换为变量名，占位符原文按首次出现的顺序写入 variables；花括号不配对时返回 false
+bool extractVariables(std::string_view source, std::string& rewritten, std::vector<std::string>& variables) {
+    rewritten.reserve(source.size());
+    for (size_t pos = 0; pos < source.size(); ++pos) {
+        char c = source[pos];
+        if (c == '}') {
+            return false;
+        }
+        if (c != '{') {
+            rewritten.push_back(c);
+            continue;
+        }
+
+        int    depth = 1;
+        size_t end   = pos + 1;
+        for (; end < source.size() && depth > 0; ++end) {
+            if (source[end] == '\\') {
+                ++end;
+            } else if (source[end] == '{') {
+                ++depth;
+            } else if (source[end] == '}') {
+                --depth;
+            }
+        }
+        if (depth != 0) {
+            return false;
+        }
+
+        std::string_view placeholder = source.substr(pos, end - pos);
+        auto             it          = std::find(variables.begin(), variables.end(), placeholder);
+        size_t           index       = static_cast<size_t>(it - variables.begin());
+        if (it == variables.end()) {
+            variables.emplace_back(placeholder);
+        }
+        rewritten.append(variableName(index));
+        pos = end - 1;
+    }
+    return true;
+}
+
+} // namespace
+
+struct MathExpression::Impl {
+    SymbolTable               symbols;
+    Expression                expression;
+    std::unique_ptr<double[]> values; // 按引用绑定到 symbols，创建后地址不再变化
+    std::mutex                mutex;
+};
+
+MathExpression::~MathExpression() = default;
+
+std::shared_ptr<const MathExpression> MathExpression::compile(std::string_view source) {
+    std::shared_ptr<MathExpression> compiled(new MathExpression());
+    compiled->mSource = std::string(source);
+
+    std::string rewritten;
+    if (!extractVariables(source, rewritten, compiled->mVariables)) {
+        compiled->mError = "unbalanced braces";
+        compiled->mVariables.clear();
+        return compiled;
+    }
+
+    auto impl    = std::make_unique<Impl>();
+    impl->values = std::make_unique<double[]>(compiled->mVariables.size());
+    for (size_t i = 0; i < compiled->mVariables.size(); ++i) {
+        impl->symbols.add_variable(variableName(i), impl->values[i]);
+    }
+    impl->symbols.add_constants();
+    impl->expression.register_symbol_table(impl->symbols);
+
+    // 表达式来自模板文本，禁止循环与 return，避免一次渲染卡住线程
+    Parser::settings_t settings;
+    settings.disable_control_structure(Parser::settings_t::e_ctrl_for_loop);
+    settings.disable_control_structure(Parser::settings_t::e_ctrl_while_loop);
+    settings.disable_control_structure(Parser::settings_t::e_ctrl_repeat_loop);
+    settings.disable_control_structure(Parser::settings_t::e_ctrl_return);
+
+    Parser parser(settings);
+    if (!parser.compile(rewritten, impl->expression)) {
+        compiled->mError = parser.error();
+        return compiled;
+    }
+    compiled->mImpl = std::move(impl);
+    return compiled;
+}
+
+double MathExpression::evaluate(std::span<const double> values) const {
+    if (!mImpl || values.size() != mVariables.size()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    std::lock_guard<std::mutex> lock(mImpl->mutex);
+    std::copy(values.begin(), values.end(), mImpl->values.get());
+    return mImpl->expression.value();
+}
+
+MathExpressionCache::MathExpressionCache(size_t capacity) : mCache(capacity) {}
+
+MathExpressionCache& MathExpressionCache::global() {
+    static MathExpressionCache instance;
+    return instance;
+}
+
+MathExpressionCache::ExpressionHandle MathExpressionCache::acquire(std::string_view source) {
+    if (mCache.capacity() == 0 || source.length() > kMaxSourceLength) {
+        return MathExpression::compile(source);
+    }
+
+    const uint64_t key = fnv1a64_constexpr(source.data(), source.size());
+    if (auto cached = mCache.get(key)) {
+        // 哈希碰撞时按未命中处理，新编译结果会覆盖旧条目
+        if (*cached && (*cached)->source() == source) {
+            return *cached;
+        }
+    }
+
+    auto compiled = MathExpression::compile(source);
+    mCache.put(key, compiled);
+    return compiled;
+}
+
+void MathExpressionCache::setCapacity(size_t capacity) { mCache.setCapacity(capacity); }
+
+void MathExpressionCache::clear() { mCache.clear(); }
+
+} // namespace PA
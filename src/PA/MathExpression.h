@@ -0,0 +1,80 @@
+// src/PA/MathExpression.h
+#pragma once
+
+#include "PA/ShardedLruCache.h"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PA {
+
+/**
+ * @brief 编译后的数学表达式（exprtk）
+ * 表达式中的 {占位符} 在编译时替换为变量，变量按引用绑定到对象内部的数组；
+ * 求值时调用方先给出各变量的数值，再整体写入并计算，不再重新解析表达式。
+ * 循环与 return 语句被禁用，单次求值的耗时只与表达式长度有关。
+ * 对象创建后可在多个线程间共享，写入变量与计算在内部互斥进行。
+ */
+class MathExpression {
+public:
+    // 编译表达式；总是返回非空对象，失败时 ok() 为 false 并可通过 error() 取得原因
+    static std::shared_ptr<const MathExpression> compile(std::string_view source);
+
+    bool               ok() const noexcept { return mImpl != nullptr; }
+    const std::string& error() const noexcept { return mError; }
+    const std::string& source() const noexcept { return mSource; }
+
+    // 变量对应的占位符原文（含花括号），下标即变量序号；重复出现的占位符共用同一变量
+    const std::vector<std::string>& variables() const noexcept { return mVariables; }
+
+    // values 的大小必须等于 variables().size()；编译失败时返回 NaN
+    double evaluate(std::span<const double> values) const;
+
+    ~MathExpression();
+
+private:
+    struct Impl;
+
+    MathExpression() = default;
+
+    std::string              mSource;
+    std::string              mError;
+    std::vector<std::string> mVariables;
+    std::unique_ptr<Impl>    mImpl;
+};
+
+/**
+ * @brief 数学表达式的编译结果缓存
+ * key 为表达式原文的哈希；编译失败的结果同样缓存，错误表达式不会在每次渲染时重新编译。
+ */
+class MathExpressionCache {
+public:
+    using ExpressionHandle = std::shared_ptr<const MathExpression>;
+
+    static constexpr size_t kDefaultCapacity = 256;
+
+    explicit MathExpressionCache(size_t capacity = kDefaultCapacity);
+
+    static MathExpressionCache& global();
+
+    // 获取（必要时编译）表达式；容量为 0 或表达式过长时每次都重新编译
+    ExpressionHandle acquire(std::string_view source);
+
+    void setCapacity(size_t capacity);
+    void clear();
+
+private:
+    struct KeyHash {
+        size_t operator()(uint64_t key) const noexcept { return static_cast<size_t>(key ^ (key >> 32)); }
+    };
+
+    static constexpr size_t kMaxSourceLength = 4096;
+
+    ShardedLruCache<uint64_t, ExpressionHandle, KeyHash> mCache;
+};
+
+} // namespace PA
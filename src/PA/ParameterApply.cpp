@@ -4,33 +4,104 @@
 #include <algorithm>
 #include <cctype>
 #include <charconv>
-#include <iomanip>
+#include <cmath>
 #include <regex>
-#include <sstream>
 
 namespace PA::ParameterParser {
 
+std::optional<double> parseNumber(std::string_view text) {
+    double value;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
 void formatNumericValue(std::string& evaluatedValue, int precision) {
     if (precision == -1) {
         return;
     }
 
-    double value;
-    auto [ptr, ec] = std::from_chars(evaluatedValue.data(), evaluatedValue.data() + evaluatedValue.size(), value);
-    if (ec == std::errc()) {
-        std::stringstream ss;
-        ss << std::fixed << std::setprecision(precision) << value;
-        evaluatedValue = ss.str();
+    if (auto value = parseNumber(evaluatedValue)) {
+        formatNumericValue(evaluatedValue, *value, precision);
     }
 }
 
+void formatNumericValue(std::string& evaluatedValue, double value, int precision) {
+    if (precision == -1) {
+        return;
+    }
+    if (precision < 0) {
+        precision = 6; // 与 std::setprecision 传入负数时的行为一致
+    }
+
+    // 定点表示的整数部分最多 309 位
+    evaluatedValue.resize(320 + static_cast<size_t>(precision));
+    char* begin    = evaluatedValue.data();
+    auto [ptr, ec] = std::to_chars(begin, begin + evaluatedValue.size(), value, std::chars_format::fixed, precision);
+    evaluatedValue.resize(ec == std::errc() ? static_cast<size_t>(ptr - begin) : 0);
+}
+
+ColorRules parseColorRules(std::string_view colorParamPart, std::string_view colorFormat) {
+    ColorRules rules;
+    rules.format = std::string(colorFormat);
+    if (colorParamPart.empty()) {
+        return rules;
+    }
+
+    std::vector<std::string_view> params;
+    size_t                        start = 0;
+    size_t                        end   = colorParamPart.find(',');
+    while (end != std::string_view::npos) {
+        params.push_back(colorParamPart.substr(start, end - start));
+        start = end + 1;
+        end   = colorParamPart.find(',', start);
+    }
+    params.push_back(colorParamPart.substr(start));
+
+    if (params.size() == 1) {
+        rules.mode     = ColorRules::Mode::Single;
+        rules.fallback = std::string(params[0]);
+        return rules;
+    }
+
+    // 偶数个分段不构成合法规则，保持不着色
+    if (params.size() >= 3 && params.size() % 2 == 1) {
+        rules.mode     = ColorRules::Mode::Threshold;
+        rules.fallback = std::string(params.back());
+        for (size_t i = 0; i < params.size() - 1; i += 2) {
+            double           threshold;
+            std::string_view threshold_sv = params[i];
+            auto [t_ptr, t_ec] =
+                std::from_chars(threshold_sv.data(), threshold_sv.data() + threshold_sv.size(), threshold);
+            if (t_ec == std::errc()) {
+                rules.thresholds.emplace_back(threshold, std::string(params[i + 1]));
+            }
+        }
+    }
+    return rules;
+}
+
 void applyColorRules(std::string& evaluatedValue, const std::string& colorParamPart, std::string_view colorFormat) {
     if (colorParamPart.empty()) {
         return;
     }
+    applyColorRules(evaluatedValue, parseColorRules(colorParamPart, colorFormat));
+}
+
+void applyColorRules(std::string& evaluatedValue, const ColorRules& colorRules) {
+    const bool needsNumber = colorRules.mode == ColorRules::Mode::Threshold;
+    applyColorRules(evaluatedValue, colorRules, needsNumber ? parseNumber(evaluatedValue) : std::nullopt);
+}
+
+void applyColorRules(std::string& evaluatedValue, const ColorRules& colorRules, std::optional<double> number) {
+    if (colorRules.mode == ColorRules::Mode::None) {
+        return;
+    }
 
     auto applyFormat = [&](const std::string& color) {
-        std::string formatted = std::string(colorFormat);
+        std::string formatted = colorRules.format;
         size_t      pos;
         while ((pos = formatted.find("{color}")) != std::string::npos) {
             formatted.replace(pos, 7, color);
@@ -41,44 +112,22 @@ void applyColorRules(std::string& evaluatedValue, const std::string& colorParamP
         evaluatedValue = formatted;
     };
 
-    std::string              currentParam(colorParamPart);
-    std::vector<std::string> params;
-    size_t                   start = 0;
-    size_t                   end   = currentParam.find(',');
-    while (end != std::string::npos) {
-        params.push_back(currentParam.substr(start, end - start));
-        start = end + 1;
-        end   = currentParam.find(',', start);
-    }
-    params.push_back(currentParam.substr(start));
-
-    if (params.size() == 1) {
-        applyFormat(params[0]);
+    if (colorRules.mode == ColorRules::Mode::Single) {
+        applyFormat(colorRules.fallback);
         return;
     }
 
-    double value;
-    auto [ptr, ec] = std::from_chars(evaluatedValue.data(), evaluatedValue.data() + evaluatedValue.size(), value);
-    if (ec != std::errc()) {
+    if (!number) {
         return;
     }
 
-    if (params.size() >= 3 && params.size() % 2 == 1) {
-        std::string appliedColor = params.back();
-        for (size_t i = 0; i < params.size() - 1; i += 2) {
-            double           threshold;
-            std::string_view threshold_sv = params[i];
-            auto [t_ptr, t_ec] =
-                std::from_chars(threshold_sv.data(), threshold_sv.data() + threshold_sv.size(), threshold);
-            if (t_ec == std::errc()) {
-                if (value < threshold) {
-                    appliedColor = params[i + 1];
-                    break;
-                }
-            }
+    for (const auto& [threshold, color] : colorRules.thresholds) {
+        if (*number < threshold) {
+            applyFormat(color);
+            return;
         }
-        applyFormat(appliedColor);
     }
+    applyFormat(colorRules.fallback);
 }
 
 // 辅助函数：修剪字符串两端的空白字符
@@ -96,10 +145,14 @@ void applyConditionalOutput(std::string& evaluatedValue, const ConditionalOutput
         return;
     }
 
-    double value;
-    auto [ptr, ec] = std::from_chars(evaluatedValue.data(), evaluatedValue.data() + evaluatedValue.size(), value);
-    if (ec != std::errc()) {
-        return;
+    if (auto value = parseNumber(evaluatedValue)) {
+        applyConditionalOutput(evaluatedValue, conditional, *value);
+    }
+}
+
+bool applyConditionalOutput(std::string& evaluatedValue, const ConditionalOutput& conditional, double value) {
+    if (!conditional.enabled) {
+        return false;
     }
 
     std::string originalValue = evaluatedValue;
@@ -140,15 +193,18 @@ void applyConditionalOutput(std::string& evaluatedValue, const ConditionalOutput
         matched = true;
     }
 
-    if (matched) {
-        size_t pos = output.find("{value}");
-        if (pos != std::string::npos) {
-            output.replace(pos, 7, originalValue);
-            evaluatedValue = output;
-        } else {
-            evaluatedValue = output + originalValue;
-        }
+    if (!matched) {
+        return false;
+    }
+
+    size_t pos = output.find("{value}");
+    if (pos != std::string::npos) {
+        output.replace(pos, 7, originalValue);
+        evaluatedValue = output;
+    } else {
+        evaluatedValue = output + originalValue;
     }
+    return true;
 }
 
 void applyBooleanMap(std::string& evaluatedValue, const BooleanMap& booleanMap) {
@@ -168,16 +224,35 @@ void applyCharReplaceMap(std::string& evaluatedValue, const CharReplaceMap& char
         return;
     }
 
-    for (const auto& pair : charReplaceMap.mappings) {
-        const std::string& from = pair.first;
-        const std::string& to   = pair.second;
+    // 未经 parse() 构建的规则在此临时编译
+    const CharReplaceMap* compiled = &charReplaceMap;
+    CharReplaceMap        local;
+    if (!charReplaceMap.matcher && !charReplaceMap.mappings.empty()) {
+        local.mappings = charReplaceMap.mappings;
+        compileCharReplaceMap(local);
+        compiled = &local;
+    }
+    if (!compiled->matcher) {
+        return;
+    }
 
-        size_t pos = evaluatedValue.find(from, 0);
-        while (pos != std::string::npos) {
-            evaluatedValue.replace(pos, from.length(), to);
-            pos = evaluatedValue.find(from, pos + to.length());
+    // 单次从左到右扫描，按最左最长匹配替换；替换结果不会再被其他规则匹配
+    const std::string_view input(evaluatedValue);
+    std::string            result_value;
+    size_t                 last_match_end = 0;
+    while (auto match = compiled->matcher->findLeftmostLongest(input, last_match_end)) {
+        if (result_value.empty()) {
+            result_value.reserve(input.size());
         }
+        result_value.append(input.substr(last_match_end, match->begin - last_match_end));
+        result_value.append(compiled->replacements[match->pattern]);
+        last_match_end = match->end;
+    }
+    if (last_match_end == 0) {
+        return; // 没有任何匹配
     }
+    result_value.append(input.substr(last_match_end));
+    evaluatedValue = std::move(result_value);
 }
 
 // 辅助函数：尝试解析大小写转换指令，例如 "\l$1" 或 "\u$1"
@@ -222,6 +297,47 @@ tryParseCaseDirective(const std::string& replacement, char directive_char, bool&
     }
 }
 
+// 辅助函数：按替换串生成一次匹配的替换文本，group(i) 返回第 i 组匹配到的文本（未参与匹配时为空）
+template <typename GroupText>
+static void appendReplacement(
+    std::string&       result_value,
+    const std::string& replacement,
+    bool               is_lowercase_replacement,
+    bool               is_uppercase_replacement,
+    int                case_group_num,
+    size_t             group_count,
+    GroupText&&        group
+) {
+    if ((is_lowercase_replacement || is_uppercase_replacement) && case_group_num >= 0
+        && case_group_num < static_cast<int>(group_count)) {
+
+        std::string captured(group(static_cast<size_t>(case_group_num)));
+        if (is_lowercase_replacement) {
+            std::transform(captured.begin(), captured.end(), captured.begin(), [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+        } else {
+            std::transform(captured.begin(), captured.end(), captured.begin(), [](unsigned char c) {
+                return static_cast<char>(std::toupper(c));
+            });
+        }
+        result_value.append(captured);
+        return;
+    }
+
+    std::string formatted_replacement = replacement;
+    for (int i = static_cast<int>(group_count) - 1; i >= 0; --i) {
+        std::string      group_placeholder = "$" + std::to_string(i);
+        std::string_view text              = group(static_cast<size_t>(i));
+        size_t           pos               = formatted_replacement.find(group_placeholder);
+        while (pos != std::string::npos) {
+            formatted_replacement.replace(pos, group_placeholder.length(), text);
+            pos = formatted_replacement.find(group_placeholder, pos + text.length());
+        }
+    }
+    result_value.append(formatted_replacement);
+}
+
 void applyRegexReplaceMap(std::string& evaluatedValue, const RegexReplaceMap& regexReplaceMap) {
     if (!regexReplaceMap.enabled) {
         return;
@@ -229,13 +345,14 @@ void applyRegexReplaceMap(std::string& evaluatedValue, const RegexReplaceMap& re
 
     logger.debug("applyRegexReplaceMap: Initial evaluatedValue='{}'", evaluatedValue);
 
-    for (const auto& pair : regexReplaceMap.mappings) {
-        const std::regex&  re          = pair.first;
-        const std::string& replacement = pair.second;
+    thread_local LinearRegex::Scratch            scratch;
+    thread_local std::vector<LinearRegex::Span> groups;
+
+    for (const auto& rule : regexReplaceMap.mappings) {
+        const std::string& replacement = rule.replacement;
         logger.debug("  Applying regex, raw replacement='{}'", replacement);
 
         std::string result_value;
-        auto        last_match_end = evaluatedValue.cbegin();
 
         bool is_lowercase_replacement = false;
         bool is_uppercase_replacement = false;
@@ -245,40 +362,63 @@ void applyRegexReplaceMap(std::string& evaluatedValue, const RegexReplaceMap& re
             tryParseCaseDirective(replacement, 'u', is_uppercase_replacement, case_group_num);
         }
 
-        for (std::sregex_iterator it(evaluatedValue.cbegin(), evaluatedValue.cend(), re), end; it != end; ++it) {
-            result_value.append(last_match_end, it->prefix().second);
-
-            if ((is_lowercase_replacement || is_uppercase_replacement) && case_group_num >= 0
-                && case_group_num < static_cast<int>(it->size())) {
-
-                std::string captured = (*it)[case_group_num].str();
-                if (is_lowercase_replacement) {
-                    std::transform(captured.begin(), captured.end(), captured.begin(), [](unsigned char c) {
-                        return static_cast<char>(std::tolower(c));
-                    });
-                } else {
-                    std::transform(captured.begin(), captured.end(), captured.begin(), [](unsigned char c) {
-                        return static_cast<char>(std::toupper(c));
-                    });
-                }
-                result_value.append(captured);
-
-            } else {
-                std::string formatted_replacement = replacement;
-                for (int i = static_cast<int>(it->size()) - 1; i >= 0; --i) {
-                    std::string group_placeholder = "$" + std::to_string(i);
-                    size_t      pos               = formatted_replacement.find(group_placeholder);
-                    while (pos != std::string::npos) {
-                        formatted_replacement.replace(pos, group_placeholder.length(), (*it)[i].str());
-                        pos = formatted_replacement.find(group_placeholder, pos + (*it)[i].str().length());
+        if (rule.linear) {
+            // 与 std::sregex_iterator 的遍历规则一致：空匹配之后先在原位置尝试非空匹配，失败再前进一个字符
+            const std::string_view input(evaluatedValue);
+            size_t                 last_match_end = 0;
+            size_t                 pos            = 0;
+            bool                   not_empty      = false;
+            while (pos <= input.size()) {
+                if (!rule.linear->search(input, pos, not_empty, groups, scratch)) {
+                    if (!not_empty) {
+                        break;
                     }
+                    not_empty = false;
+                    ++pos;
+                    continue;
                 }
-                result_value.append(formatted_replacement);
+                result_value.append(input.substr(last_match_end, groups[0].begin - last_match_end));
+                appendReplacement(
+                    result_value,
+                    replacement,
+                    is_lowercase_replacement,
+                    is_uppercase_replacement,
+                    case_group_num,
+                    groups.size(),
+                    [&](size_t i) {
+                        return groups[i].matched() ? input.substr(groups[i].begin, groups[i].end - groups[i].begin)
+                                                   : std::string_view{};
+                    }
+                );
+                last_match_end = groups[0].end;
+                not_empty      = groups[0].begin == groups[0].end;
+                pos            = groups[0].end;
             }
-
-            last_match_end = it->suffix().first;
+            result_value.append(input.substr(last_match_end));
+        } else {
+            auto last_match_end = evaluatedValue.cbegin();
+            for (std::sregex_iterator it(evaluatedValue.cbegin(), evaluatedValue.cend(), *rule.fallback), end;
+                 it != end;
+                 ++it) {
+                result_value.append(last_match_end, it->prefix().second);
+                appendReplacement(
+                    result_value,
+                    replacement,
+                    is_lowercase_replacement,
+                    is_uppercase_replacement,
+                    case_group_num,
+                    it->size(),
+                    [&](size_t i) {
+                        const auto& sub = (*it)[i];
+                        return sub.matched ? std::string_view(evaluatedValue)
+                                                 .substr(sub.first - evaluatedValue.cbegin(), sub.length())
+                                           : std::string_view{};
+                    }
+                );
+                last_match_end = it->suffix().first;
+            }
+            result_value.append(last_match_end, evaluatedValue.cend());
         }
-        result_value.append(last_match_end, evaluatedValue.cend());
         evaluatedValue = result_value;
         logger.debug("  After applying regex, evaluatedValue='{}'", evaluatedValue);
     }
@@ -1,12 +1,32 @@
 // src/PA/ParameterParser.cpp
 #include "PA/ParameterParser.h"
 #include "PA/logger.h" // 引入 logger 头文件
+#include <atomic>
 #include <charconv>
 #include <sstream>
 #include <vector>
 
 namespace PA::ParameterParser {
 
+namespace {
+std::atomic<RegexEngine> gRegexEngine{RegexEngine::Linear};
+} // namespace
+
+void setRegexEngine(RegexEngine engine) { gRegexEngine.store(engine, std::memory_order_relaxed); }
+
+void compileCharReplaceMap(CharReplaceMap& charReplaceMap) {
+    std::vector<std::string_view> patterns;
+    charReplaceMap.replacements.clear();
+    for (const auto& [from, to] : charReplaceMap.mappings) {
+        if (from.empty()) {
+            continue; // 空模式会在每个位置匹配，没有意义
+        }
+        patterns.push_back(from);
+        charReplaceMap.replacements.push_back(to);
+    }
+    charReplaceMap.matcher = AhoCorasick::build(patterns);
+}
+
 // 辅助函数：根据逗号分割参数字符串，同时处理引号、转义和括号/花括号嵌套
 std::vector<std::string> splitParamString(std::string_view paramPart, char delimiter) {
     std::vector<std::string> segments;
@@ -169,6 +189,7 @@ PlaceholderParams parse(std::string_view paramPart) {
                         std::string(rule.substr(colon_pos + 1));
                 }
             }
+            compileCharReplaceMap(params.charReplaceMap);
         } else if (p.rfind("json_map=", 0) == 0) {
             params.jsonMap.enabled    = true;
             std::string_view json_sv = std::string_view(p).substr(9); // "json_map=".length()
@@ -185,13 +206,26 @@ PlaceholderParams parse(std::string_view paramPart) {
             auto add_mapping = [&](std::string_view rule) {
                 size_t colon_pos = rule.find(':');
                 if (colon_pos != std::string_view::npos) {
-                    std::string regex_str = std::string(rule.substr(0, colon_pos));
-                    std::string replacement = std::string(rule.substr(colon_pos + 1));
+                    std::string      regex_str = std::string(rule.substr(0, colon_pos));
+                    RegexReplaceRule compiled;
+                    compiled.replacement = std::string(rule.substr(colon_pos + 1));
+                    if (gRegexEngine.load(std::memory_order_relaxed) == RegexEngine::Linear) {
+                        compiled.linear = LinearRegex::compile(regex_str);
+                    }
+                    if (compiled.linear) {
+                        params.regexReplaceMap.mappings.push_back(std::move(compiled));
+                        return;
+                    }
                     try {
-                        params.regexReplaceMap.mappings.emplace_back(
-                            std::regex(regex_str, std::regex_constants::optimize),
-                            replacement
-                        );
+                        compiled.fallback.emplace(regex_str, std::regex_constants::optimize);
+                        if (gRegexEngine.load(std::memory_order_relaxed) == RegexEngine::Linear) {
+                            // 回溯引擎对嵌套量词等写法可能耗时指数增长，提示用户改写模式
+                            logger.warn(
+                                "Regex pattern '{}' is not supported by the linear engine, falling back to std::regex",
+                                regex_str
+                            );
+                        }
+                        params.regexReplaceMap.mappings.push_back(std::move(compiled));
                     } catch (const std::regex_error& e) {
                         logger.error("Invalid regex pattern '{}': {}", regex_str, e.what());
                     }
@@ -221,6 +255,12 @@ PlaceholderParams parse(std::string_view paramPart) {
         params.colorParamPart = ss.str();
     }
 
+    auto colorFormat  = params.otherParams.find("color_format");
+    params.colorRules = parseColorRules(
+        params.colorParamPart,
+        colorFormat != params.otherParams.end() ? std::string_view(colorFormat->second) : "{color}{value}"
+    );
+
     return params;
 }
 
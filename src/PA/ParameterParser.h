@@ -4,9 +4,13 @@
 #include <string>
 #include <string_view>
 #include <map>
+#include <memory>
+#include <optional>
 #include <vector>
 #include <regex>
 #include <nlohmann/json.hpp>
+#include "PA/AhoCorasick.h"
+#include "PA/LinearRegex.h"
 #include "PA/PlaceholderAPI.h"
 
 namespace PA {
@@ -36,16 +40,31 @@ struct BooleanMap {
     std::map<std::string, std::string> mappings;
 };
 
-// 表示字符替换映射规则
+// 表示字符替换映射规则；matcher 与 replacements 由 mappings 编译而来，下标一一对应
 struct CharReplaceMap {
-    bool                   enabled = false;
+    bool                               enabled = false;
     std::map<std::string, std::string> mappings;
+    std::shared_ptr<const AhoCorasick> matcher;
+    std::vector<std::string>           replacements;
+};
+
+// regex_map 使用的正则引擎
+enum class RegexEngine {
+    Linear, // 线性时间引擎，模式超出其支持范围时回退到 std::regex
+    Std     // 始终使用 std::regex
+};
+
+// 表示单条正则替换规则；linear 与 fallback 恰有一个有效
+struct RegexReplaceRule {
+    std::shared_ptr<const LinearRegex> linear;
+    std::optional<std::regex>          fallback;
+    std::string                        replacement;
 };
 
 // 表示正则表达式替换映射规则
 struct RegexReplaceMap {
-    bool                                           enabled = false;
-    std::vector<std::pair<std::regex, std::string>> mappings;
+    bool                          enabled = false;
+    std::vector<RegexReplaceRule> mappings;
 };
 
 // 表示JSON映射规则
@@ -54,10 +73,19 @@ struct JsonMap {
     nlohmann::json mappings;
 };
 
+// 表示预先拆分的颜色规则：单个颜色直接套用；奇数个分段时按 阈值,颜色,...,默认颜色 依次比较，数值小于阈值即使用对应颜色
+struct ColorRules {
+    enum class Mode { None, Single, Threshold } mode = Mode::None;
+    std::vector<std::pair<double, std::string>> thresholds; // 无法解析的阈值已在解析时跳过
+    std::string                                 fallback;   // 单个颜色，或所有阈值都未命中时的颜色
+    std::string                                 format = "{color}{value}";
+};
+
 // 表示从占位符解析的参数
 struct PlaceholderParams {
     int                                precision = -1;
     std::string                        colorParamPart;
+    ColorRules                         colorRules;      // 由 colorParamPart 与 color_format 预先拆分
     std::map<std::string, std::string> otherParams;
     ConditionalOutput                  conditional;
     BooleanMap                         booleanMap;
@@ -69,18 +97,42 @@ struct PlaceholderParams {
 // 辅助函数：根据逗号分割参数字符串，同时处理引号、转义和括号/花括号嵌套
 std::vector<std::string> splitParamString(std::string_view paramPart, char delimiter);
 
+// 设置之后解析的 regex_map 使用的正则引擎；已解析的规则不受影响
+void setRegexEngine(RegexEngine engine);
+
+// 由 mappings 构建字符替换的多模式自动机
+void compileCharReplaceMap(CharReplaceMap& charReplaceMap);
+
 // 解析占位符的参数部分
 PlaceholderParams parse(std::string_view paramPart);
 
+// 把文本开头解析为数值，与各格式化阶段原有的判定一致；无法解析时返回 std::nullopt
+std::optional<double> parseNumber(std::string_view text);
+
 // 根据给定精度格式化数值字符串
 void formatNumericValue(std::string& evaluatedValue, int precision);
 
+// 以给定精度把已知数值写为文本，不再从 evaluatedValue 解析
+void formatNumericValue(std::string& evaluatedValue, double value, int precision);
+
+// 拆分颜色规则参数，结果可反复应用
+ColorRules parseColorRules(std::string_view colorParamPart, std::string_view colorFormat);
+
 // 将颜色规则应用于评估值
 void applyColorRules(std::string& evaluatedValue, const std::string& colorParamPart, std::string_view colorFormat);
 
+// 将预先拆分的颜色规则应用于评估值
+void applyColorRules(std::string& evaluatedValue, const ColorRules& colorRules);
+
+// 将预先拆分的颜色规则应用于评估值；阈值比较使用 number，为空时按文本不着色
+void applyColorRules(std::string& evaluatedValue, const ColorRules& colorRules, std::optional<double> number);
+
 // 将条件输出规则应用于评估值
 void applyConditionalOutput(std::string& evaluatedValue, const ConditionalOutput& conditional);
 
+// 以已知数值判定条件输出规则；返回是否改写了 evaluatedValue
+bool applyConditionalOutput(std::string& evaluatedValue, const ConditionalOutput& conditional, double value);
+
 // 将布尔值映射规则应用于评估值
 void applyBooleanMap(std::string& evaluatedValue, const BooleanMap& booleanMap);
 
@@ -0,0 +1,242 @@
+// src/PA/PersistentHashMap.h
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace PA {
+
+/**
+ * @brief 持久化哈希映射（HAMT，哈希数组映射前缀树）
+ * 拷贝只复制根指针，与原映射共享全部节点；修改时只复制从根到目标条目的 O(log n) 条路径，其余节点继续共享。
+ * 仅被当前映射引用的节点直接原地修改，因此对同一份私有副本连续修改不会重复复制路径。
+ * 同一对象不可并发修改；不同副本之间互不影响，已发布的副本可被任意线程并发只读。
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>>
+class PersistentHashMap {
+public:
+    using key_type    = K;
+    using mapped_type = V;
+
+    size_t size() const noexcept { return mSize; }
+    bool   empty() const noexcept { return mSize == 0; }
+
+    // 支持 Hash/Equal 接受的异构 key（如以 string_view 查找 string key）
+    template <typename Q>
+    const V* find(const Q& key) const {
+        return find(key, Hash{}(key));
+    }
+
+    // rawHash 须等于 Hash{}(key)，供已增量算好哈希的调用方省去重复计算
+    template <typename Q>
+    const V* find(const Q& key, size_t rawHash) const {
+        const uint64_t hash = mix(rawHash);
+        const Node*    node = mRoot.get();
+        for (unsigned shift = 0; node; shift += kBits) {
+            if (shift >= kMaxShift) {
+                for (const Leaf& leaf : node->data) {
+                    if (leaf.hash == hash && Equal{}(leaf.key, key)) {
+                        return &leaf.value;
+                    }
+                }
+                return nullptr;
+            }
+            const uint32_t bit = bitFor(hash, shift);
+            if (node->dataMap & bit) {
+                const Leaf& leaf = node->data[indexOf(node->dataMap, bit)];
+                return leaf.hash == hash && Equal{}(leaf.key, key) ? &leaf.value : nullptr;
+            }
+            if (!(node->nodeMap & bit)) {
+                return nullptr;
+            }
+            node = node->children[indexOf(node->nodeMap, bit)].get();
+        }
+        return nullptr;
+    }
+
+    template <typename Q>
+    bool contains(const Q& key) const {
+        return find(key) != nullptr;
+    }
+
+    // 与 unordered_map::operator[] 相同：不存在时插入默认值；返回的引用在下一次修改前有效
+    V& operator[](K key) {
+        const uint64_t hash = hashOf(key);
+        if (!mRoot) {
+            mRoot = std::make_shared<Node>();
+        }
+        bool inserted = false;
+        V&   value    = insert(mRoot, 0, hash, std::move(key), inserted);
+        if (inserted) {
+            ++mSize;
+        }
+        return value;
+    }
+
+    template <typename Q>
+    size_t erase(const Q& key) {
+        if (!find(key)) {
+            return 0; // 不存在时不复制任何节点
+        }
+        eraseFrom(mRoot, 0, hashOf(key), key);
+        if (--mSize == 0) {
+            mRoot.reset();
+        }
+        return 1;
+    }
+
+    // fn(const K&, const V&)，顺序不确定
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        if (mRoot) {
+            visit(*mRoot, fn);
+        }
+    }
+
+private:
+    static constexpr unsigned kBits     = 5;
+    static constexpr unsigned kMaxShift = 64; // 哈希位耗尽后的节点退化为线性存放的冲突节点
+
+    struct Leaf {
+        uint64_t hash{};
+        K        key{};
+        V        value{};
+    };
+
+    struct Node {
+        uint32_t                           dataMap{}; // 直接存放条目的槽位
+        uint32_t                           nodeMap{}; // 指向子节点的槽位
+        std::vector<Leaf>                  data;      // 按槽位顺序存放
+        std::vector<std::shared_ptr<Node>> children;  // 按槽位顺序存放
+    };
+
+    template <typename Q>
+    static uint64_t hashOf(const Q& key) {
+        return mix(Hash{}(key));
+    }
+
+    // 再混合一次，避免 std::hash 对整数/指针的恒等映射集中在少数槽位
+    static uint64_t mix(size_t rawHash) noexcept {
+        auto h  = static_cast<uint64_t>(rawHash);
+        h      ^= h >> 33;
+        h      *= 0xff51afd7ed558ccdull;
+        h      ^= h >> 33;
+        h      *= 0xc4ceb9fe1a85ec53ull;
+        h      ^= h >> 33;
+        return h;
+    }
+
+    static uint32_t bitFor(uint64_t hash, unsigned shift) noexcept {
+        return uint32_t{1} << ((hash >> shift) & ((1u << kBits) - 1));
+    }
+
+    static size_t indexOf(uint32_t map, uint32_t bit) noexcept {
+        return static_cast<size_t>(std::popcount(map & (bit - 1)));
+    }
+
+    // 节点被其他版本共享时先复制一份，保证后续修改不影响其他版本
+    static Node& makeUnique(std::shared_ptr<Node>& slot) {
+        if (slot.use_count() != 1) {
+            slot = std::make_shared<Node>(*slot);
+        }
+        return *slot;
+    }
+
+    static V& insert(std::shared_ptr<Node>& slot, unsigned shift, uint64_t hash, K&& key, bool& inserted) {
+        Node& node = makeUnique(slot);
+        if (shift >= kMaxShift) {
+            for (Leaf& leaf : node.data) {
+                if (leaf.hash == hash && Equal{}(leaf.key, key)) {
+                    return leaf.value;
+                }
+            }
+            inserted = true;
+            return node.data.emplace_back(Leaf{hash, std::move(key), V{}}).value;
+        }
+
+        const uint32_t bit = bitFor(hash, shift);
+        if (node.nodeMap & bit) {
+            return insert(node.children[indexOf(node.nodeMap, bit)], shift + kBits, hash, std::move(key), inserted);
+        }
+
+        const size_t index = indexOf(node.dataMap, bit);
+        if (!(node.dataMap & bit)) {
+            inserted      = true;
+            node.dataMap |= bit;
+            return node.data.insert(node.data.begin() + index, Leaf{hash, std::move(key), V{}})->value;
+        }
+        if (node.data[index].hash == hash && Equal{}(node.data[index].key, key)) {
+            return node.data[index].value;
+        }
+
+        // 槽位已被其他 key 占用：把原条目下沉到新的子节点，再继续插入
+        auto child = std::make_shared<Node>();
+        pushDown(*child, shift + kBits, std::move(node.data[index]));
+        node.data.erase(node.data.begin() + index);
+        node.dataMap &= ~bit;
+        node.nodeMap |= bit;
+        auto& childSlot = *node.children.insert(node.children.begin() + indexOf(node.nodeMap, bit), std::move(child));
+        return insert(childSlot, shift + kBits, hash, std::move(key), inserted);
+    }
+
+    static void pushDown(Node& empty, unsigned shift, Leaf&& leaf) {
+        if (shift < kMaxShift) {
+            empty.dataMap = bitFor(leaf.hash, shift);
+        }
+        empty.data.push_back(std::move(leaf));
+    }
+
+    // 调用方保证 key 存在
+    template <typename Q>
+    static void eraseFrom(std::shared_ptr<Node>& slot, unsigned shift, uint64_t hash, const Q& key) {
+        Node& node = makeUnique(slot);
+        if (shift >= kMaxShift) {
+            auto it = std::find_if(node.data.begin(), node.data.end(), [&](const Leaf& leaf) {
+                return leaf.hash == hash && Equal{}(leaf.key, key);
+            });
+            node.data.erase(it);
+            return;
+        }
+
+        const uint32_t bit = bitFor(hash, shift);
+        if (node.dataMap & bit) {
+            node.data.erase(node.data.begin() + indexOf(node.dataMap, bit));
+            node.dataMap &= ~bit;
+            return;
+        }
+
+        const size_t childIndex = indexOf(node.nodeMap, bit);
+        eraseFrom(node.children[childIndex], shift + kBits, hash, key);
+
+        // 子树只剩一个条目时上提到本节点，保持“每棵子树至少两个条目”，查找路径不会无谓变长
+        Node& child = *node.children[childIndex];
+        if (child.children.empty() && child.data.size() == 1) {
+            Leaf leaf = std::move(child.data.front());
+            node.children.erase(node.children.begin() + childIndex);
+            node.nodeMap &= ~bit;
+            node.data.insert(node.data.begin() + indexOf(node.dataMap, bit), std::move(leaf));
+            node.dataMap |= bit;
+        }
+    }
+
+    template <typename Fn>
+    static void visit(const Node& node, Fn& fn) {
+        for (const Leaf& leaf : node.data) {
+            fn(leaf.key, leaf.value);
+        }
+        for (const auto& child : node.children) {
+            visit(*child, fn);
+        }
+    }
+
+    std::shared_ptr<Node> mRoot;
+    size_t                mSize{};
+};
+
+} // namespace PA
@@ -2,8 +2,11 @@
 #pragma once
 
 #include "mc/deps/core/math/Vec3.h"
+#include <charconv>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -52,6 +55,10 @@ struct PA_API IContext {
     virtual const std::vector<uint64_t>& getInheritedTypeIds() const noexcept = 0;
     // 方法：获取上下文实例的唯一键（例如，玩家UUID，方块位置哈希）
     virtual std::string getContextInstanceKey() const noexcept { return ""; }
+    // 方法：获取上下文实例的 64 位标识，作为缓存 key 与 invalidateInstance() 的参数使用。
+    // 非虚函数，不改变 IContext 的虚表布局：内置上下文直接返回对象地址（最高位为 0），
+    // 其他上下文返回 getContextInstanceKey() 的哈希并置最高位，哈希相同时缓存内部还会比较实例键原文；实例键为空时返回 0
+    uint64_t instanceId() const noexcept;
 };
 
 // 约定：服务器级（无上下文）占位符的上下文 ID = 0
@@ -282,6 +289,125 @@ struct PA_API WorldCoordinateContext : public IContext {
     }
 };
 
+// 预编译模板（不透明类型），由 IPlaceholderService::compile 创建，可跨线程共享
+struct CompiledTemplate;
+using CompiledTemplateHandle = std::shared_ptr<const CompiledTemplate>;
+
+// replace()/replaceServer() 背后模板缓存的统计信息，可用于评估 globalCacheSize 是否合适
+struct TemplateCacheStats {
+    uint64_t hits{};      // 命中次数
+    uint64_t misses{};    // 未命中次数
+    uint64_t evictions{}; // 因容量不足被淘汰的条目数
+    uint64_t bypassed{};  // 首次出现、未准入缓存而直接处理的次数
+    uint64_t size{};      // 当前条目数
+    uint64_t capacity{};  // 容量上限（0 表示禁用）
+};
+
+// 缓存占位符值缓存的统计信息，可用于评估 valueCacheMaxEntries/valueCacheMaxMemoryMB 是否合适
+struct ValueCacheStats {
+    uint64_t hits{};            // 共享缓存命中次数
+    uint64_t localHits{};       // 由线程本地 L1 直接回答、未访问共享缓存的命中次数
+    uint64_t misses{};          // 未命中或已过期的次数
+    uint64_t evictions{};       // 因条目数或内存上限被淘汰的条目数
+    uint64_t rejections{};      // 访问频率不足、未被准入主区而丢弃的新值数
+    uint64_t quotaEvictions{};  // 因单个占位符超出配额而淘汰其自身旧值的次数
+    uint64_t invalidations{};   // 因上下文实例失效（invalidateInstance）被移除的条目数
+    uint64_t expirations{};     // 过期后由时间轮回收的条目数
+    uint64_t staleHits{};       // 过期后仍返回旧值（stale-while-revalidate）的次数
+    uint64_t refreshes{};       // 提交到执行器的后台刷新次数
+    uint64_t flightWaits{};     // 未命中时发现同一 key 已在求值、转而等待其结果的次数（单飞争用）
+    uint64_t coalesced{};       // 直接复用在途求值结果、省去一次求值的次数
+    uint64_t flightFallbacks{}; // 等待超时或领头求值失败、改为自行求值的次数
+    uint64_t size{};            // 当前条目数
+    uint64_t bytes{};           // 当前估算占用的字节数
+    uint64_t capacity{};        // 条目数上限（0 表示禁用）
+    uint64_t byteCapacity{};    // 字节数上限
+};
+
+// 缓存占位符的刷新策略（IExtendedPlaceholder::getCacheFlags() 的返回值，可按位组合）。
+// 刷新类策略仅对服务器级占位符生效，刷新任务交给 IPlaceholderService::setCacheExecutor() 设置的执行器，
+// 未设置执行器时退化为普通缓存
+enum CacheFlags : uint32_t {
+    kCacheRefreshAhead         = 1u << 0, // 过期前不久，若该值自上次求值后被读取过，则提前在执行器上重新求值
+    kCacheStaleWhileRevalidate = 1u << 1, // 过期后的一个缓存周期内继续返回旧值，同时只发起一次后台刷新
+    kCacheSingleFlight         = 1u << 2, // 同一 key 的并发未命中只求值一次，其余线程等待并复用结果；适用于所有上下文
+};
+
+// 执行器：接收一个任务并在合适的线程上执行（例如服务器主线程）
+using CacheExecutor = std::function<void(std::function<void()>)>;
+
+// 占位符的类型化求值结果（IExtendedPlaceholder::evaluateTyped 的输出）
+// 文本形式：Int 为十进制整数，Double 为 6 位小数的定点数（与 std::to_string 一致），Bool 为 true/false
+struct PlaceholderValue {
+    enum class Type : uint8_t { String, Int, Double, Bool };
+
+    Type        type{Type::String};
+    int64_t     intValue{};
+    double      doubleValue{};
+    bool        boolValue{};
+    std::string stringValue;
+
+    static PlaceholderValue ofInt(int64_t value) {
+        PlaceholderValue v;
+        v.type     = Type::Int;
+        v.intValue = value;
+        return v;
+    }
+
+    static PlaceholderValue ofDouble(double value) {
+        PlaceholderValue v;
+        v.type        = Type::Double;
+        v.doubleValue = value;
+        return v;
+    }
+
+    static PlaceholderValue ofBool(bool value) {
+        PlaceholderValue v;
+        v.type      = Type::Bool;
+        v.boolValue = value;
+        return v;
+    }
+
+    static PlaceholderValue ofString(std::string value) {
+        PlaceholderValue v;
+        v.stringValue = std::move(value);
+        return v;
+    }
+
+    // 数值形式，供条件输出、精度与颜色阈值直接使用；String 与 Bool 返回 std::nullopt，由调用方按文本处理
+    std::optional<double> number() const noexcept {
+        switch (type) {
+        case Type::Int:
+            return static_cast<double>(intValue);
+        case Type::Double:
+            return doubleValue;
+        default:
+            return std::nullopt;
+        }
+    }
+
+    // 把文本形式追加到 out
+    void appendTo(std::string& out) const {
+        char buffer[400]; // 足以容纳任意 double 的 6 位小数定点表示
+        switch (type) {
+        case Type::Int:
+            out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), intValue).ptr);
+            break;
+        case Type::Double: {
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), doubleValue, std::chars_format::fixed, 6);
+            out.append(buffer, result.ptr);
+            break;
+        }
+        case Type::Bool:
+            out.append(boolValue ? "true" : "false");
+            break;
+        case Type::String:
+            out.append(stringValue);
+            break;
+        }
+    }
+};
+
 // 占位符抽象基类：通过继承来定义不同占位符
 struct PA_API IPlaceholder {
     virtual ~IPlaceholder() = default;
@@ -310,6 +436,28 @@ struct PA_API IPlaceholder {
     virtual bool isContextAliasPlaceholder() const noexcept { return false; }
 };
 
+// 占位符的可选扩展接口：新增能力放在派生接口中而不是追加到 IPlaceholder 的虚表末尾，
+// 按旧头文件编译的插件无需重新编译即可继续注册。PA 在注册时以 dynamic_cast 检测该接口，
+// 未实现它的占位符按下列方法的默认返回值处理
+struct PA_API IExtendedPlaceholder : public IPlaceholder {
+    // 方法：获取缓存刷新策略（CacheFlags 按位组合），仅在 getCacheDuration() > 0 时有意义
+    virtual uint32_t getCacheFlags() const noexcept { return 0; }
+
+    // 方法：值在同一游戏刻内是否不变（生命值、坐标、计分板分数等）。
+    // 为 true 且未缓存时，EvaluationScope 内同一 {上下文实例, 参数} 只求值一次
+    virtual bool isTickStable() const noexcept { return false; }
+
+    // 方法：类型化求值。返回 true 表示已写入 out，格式化管线直接使用其中的数值、只生成一次文本；
+    // 返回 false（默认）时调用方改用 evaluate()/evaluateWithArgs()。out 的文本形式必须与 evaluate 的输出一致
+    virtual bool evaluateTyped(
+        const IContext* /* ctx */,
+        const std::vector<std::string_view>& /* args */,
+        PlaceholderValue& /* out */
+    ) const {
+        return false;
+    }
+};
+
 
 // 颜色代码定义
 #define PA_COLOR_RED    "§c"
@@ -430,6 +578,82 @@ struct PA_API IPlaceholderService {
     // 注册“上下文工厂”
     // 用于在上下文别名解析时，动态构造目标上下文实例
     virtual void registerContextFactory(uint64_t contextTypeId, ContextFactoryFn factory, void* owner) = 0;
+
+    // 预编译模板：文本只扫描一次，适合反复渲染的固定模板（计分板、Boss 栏等）
+    // 返回的句柄不可变，可长期持有；注册表变化或切换正则引擎后会在下次 render 时自动重新绑定
+    virtual CompiledTemplateHandle compile(std::string_view text) const = 0;
+
+    // 渲染预编译模板：ctx 为 nullptr 时仅替换服务器占位符，结果与 replace/replaceServer 一致
+    virtual std::string render(const CompiledTemplateHandle& tpl, const IContext* ctx) const = 0;
+
+    // 获取 replace()/replaceServer() 模板缓存的统计信息
+    virtual TemplateCacheStats getTemplateCacheStats() const = 0;
+
+    // 批量注册：beginBatch() 与 commitBatch() 之间的所有注册/反注册只复制一次快照、只发布一次
+    // 必须在同一线程上成对调用（可嵌套），推荐使用下方的 PlaceholderBatch
+    virtual void beginBatch()  = 0;
+    virtual void commitBatch() = 0;
+
+    // 获取缓存占位符值缓存的统计信息（命中/未命中/淘汰/准入拒绝等）
+    virtual ValueCacheStats getValueCacheStats() const = 0;
+
+    // 上下文实例生命周期结束（玩家离开、实体移除、方块实体销毁等）时调用，
+    // 移除所有缓存占位符中属于该实例的缓存值，避免条目泄漏以及地址被复用后新实例读到旧值。
+    // instanceId 为该上下文的 IContext::instanceId()；同一对象的 Player/Mob/Actor 视图共享同一 id，会一并移除。
+    // 服务器级缓存值不属于任何实例；instanceId 为 0（空上下文或空实例键）时不做任何操作
+    virtual void invalidateInstance(uint64_t instanceId) = 0;
+
+    // 设置缓存占位符后台刷新（kCacheRefreshAhead/kCacheStaleWhileRevalidate）使用的执行器；传入空函数则停用后台刷新
+    virtual void setCacheExecutor(CacheExecutor executor) = 0;
+
+    // 求值作用域：beginEvaluationScope() 与 endEvaluationScope() 之间，当前线程上渲染的所有文本与模板中，
+    // 未缓存且 IExtendedPlaceholder::isTickStable() 的占位符对同一 {上下文实例, 参数} 只求值一次并看到同一个值；
+    // 退出最外层作用域时备忘整体失效。
+    // 适合在一个游戏刻或一批渲染前后调用；必须在同一线程上成对调用（可嵌套），推荐使用下方的 EvaluationScope
+    virtual void beginEvaluationScope() = 0;
+    virtual void endEvaluationScope()   = 0;
+};
+
+// RAII 批量注册作用域：构造时 beginBatch()，析构时 commitBatch()
+class PlaceholderBatch {
+public:
+    explicit PlaceholderBatch(IPlaceholderService* service) : mService(service) {
+        if (mService) {
+            mService->beginBatch();
+        }
+    }
+    ~PlaceholderBatch() {
+        if (mService) {
+            mService->commitBatch();
+        }
+    }
+
+    PlaceholderBatch(const PlaceholderBatch&)            = delete;
+    PlaceholderBatch& operator=(const PlaceholderBatch&) = delete;
+
+private:
+    IPlaceholderService* mService;
+};
+
+// RAII 求值作用域：构造时 beginEvaluationScope()，析构时 endEvaluationScope()
+class EvaluationScope {
+public:
+    explicit EvaluationScope(IPlaceholderService* service) : mService(service) {
+        if (mService) {
+            mService->beginEvaluationScope();
+        }
+    }
+    ~EvaluationScope() {
+        if (mService) {
+            mService->endEvaluationScope();
+        }
+    }
+
+    EvaluationScope(const EvaluationScope&)            = delete;
+    EvaluationScope& operator=(const EvaluationScope&) = delete;
+
+private:
+    IPlaceholderService* mService;
 };
 
 // 跨模块获取占位符服务单例
@@ -0,0 +1,916 @@
+// src/PA/PlaceholderCacheStore.cpp
+#include "PA/PlaceholderCacheStore.h"
+#include "PA/EpochDomain.h"
+
+#include <algorithm>
+#include <bit>
+#include <optional>
+#include <utility>
+
+namespace PA {
+
+namespace {
+
+// 单条缓存值的额外内存估算：哈希表节点、Node、三条链表节点、序号索引与 ValueBlob（含控制块）；
+// 参数与实例键在 blob 中另存一份
+constexpr size_t kEntryOverhead = 352;
+
+// 已摘除的对象攒够一批再交给 EpochDomain，避免每次写入都推进全局 epoch
+constexpr size_t kRetireBatch = 64;
+
+// 时间轮精度：过期回收与提前刷新最多延迟一个 tick
+constexpr std::chrono::milliseconds kTimerTick{250};
+
+// 提前刷新的提前量：缓存时长的 1/10，至少两个 tick，且不超过缓存时长的一半
+std::chrono::steady_clock::duration refreshAheadMargin(std::chrono::steady_clock::duration ttl) {
+    using Duration = std::chrono::steady_clock::duration;
+    return std::min<Duration>(std::max<Duration>(ttl / 10, kTimerTick * 2), ttl / 2);
+}
+
+// 线程本地 L1 的有效期上限：约一个游戏刻。同一刻内的重复读取由 L1 回答，热点值仍会周期性地回到共享缓存刷新其访问记录
+constexpr std::chrono::milliseconds kLocalLifetime{50};
+
+constexpr size_t kLocalSlots = 256;
+
+std::atomic<uint64_t> gNextEpoch{1};
+
+// 当前线程写入的计数器与读缓冲条带，避免所有线程争用同一缓存行
+size_t localStripe() {
+    thread_local const size_t stripe = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return stripe;
+}
+
+} // namespace
+
+// 线程本地 L1 的一个槽位；epoch 为 0 表示空槽。持有 blob 的引用，命中时无需进入 EpochDomain 临界区
+struct PlaceholderCacheStore::LocalSlot {
+    uint64_t                              epoch{};
+    uint64_t                              generation{};
+    std::chrono::steady_clock::time_point validUntil;
+    BlobRef                               blob;
+};
+
+// 所有 store 共用每个线程的 L1，以全局唯一的 epoch 区分；epoch 从不重复，store 销毁或重新配置后旧槽位自然失效
+PlaceholderCacheStore::LocalSlot& PlaceholderCacheStore::localSlot(uint64_t hash) {
+    thread_local std::array<LocalSlot, kLocalSlots> slots;
+    return slots[hash & (kLocalSlots - 1)];
+}
+
+// ========== StripedCounter ==========
+
+void PlaceholderCacheStore::StripedCounter::add(uint64_t n) noexcept {
+    mStripes[localStripe() % kCounterStripes].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+uint64_t PlaceholderCacheStore::StripedCounter::load() const noexcept {
+    uint64_t sum = 0;
+    for (const Stripe& stripe : mStripes) {
+        sum += stripe.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+// ========== FrequencySketch ==========
+
+void PlaceholderCacheStore::FrequencySketch::resize(size_t capacity) {
+    const size_t width = std::bit_ceil(std::max<size_t>(capacity, 16));
+    if (width - 1 == mWidthMask && !mTable.empty()) {
+        return;
+    }
+    mTable.assign(width * kDepth, 0);
+    mWidthMask  = width - 1;
+    mAdditions  = 0;
+    mSampleSize = std::max<size_t>(capacity, 1) * 10;
+}
+
+size_t PlaceholderCacheStore::FrequencySketch::indexOf(uint64_t hash, size_t row) const {
+    static constexpr uint64_t kSeeds[kDepth] = {
+        0x97cb3127e5c3f1b7ull,
+        0xc2b2ae3d27d4eb4full,
+        0x165667b19e3779f9ull,
+        0x9e3779b97f4a7c15ull,
+    };
+    const uint64_t h = (hash ^ (hash >> 29)) * kSeeds[row];
+    return row * (mWidthMask + 1) + static_cast<size_t>((h >> 32) & mWidthMask);
+}
+
+void PlaceholderCacheStore::FrequencySketch::increment(uint64_t hash) {
+    if (mTable.empty()) {
+        return;
+    }
+    bool added = false;
+    for (size_t row = 0; row < kDepth; ++row) {
+        uint8_t& counter = mTable[indexOf(hash, row)];
+        if (counter < 15) {
+            ++counter;
+            added = true;
+        }
+    }
+    if (added && ++mAdditions >= mSampleSize) {
+        for (uint8_t& counter : mTable) {
+            counter >>= 1;
+        }
+        mAdditions /= 2;
+    }
+}
+
+unsigned PlaceholderCacheStore::FrequencySketch::estimate(uint64_t hash) const {
+    if (mTable.empty()) {
+        return 0;
+    }
+    unsigned result = 15;
+    for (size_t row = 0; row < kDepth; ++row) {
+        result = std::min<unsigned>(result, mTable[indexOf(hash, row)]);
+    }
+    return result;
+}
+
+// ========== PlaceholderCacheStore ==========
+
+PlaceholderCacheStore::PlaceholderCacheStore(
+    size_t                    maxEntries,
+    size_t                    maxBytes,
+    unsigned                  quotaPercent,
+    std::chrono::milliseconds flightWait
+)
+: mTimers(kTimerTick),
+  mEpoch(gNextEpoch.fetch_add(1, std::memory_order_relaxed)) {
+    mNextTickAt.store(mTimers.nextTickAt().time_since_epoch().count(), std::memory_order_relaxed);
+    configure(maxEntries, maxBytes, quotaPercent, flightWait);
+}
+
+void PlaceholderCacheStore::configure(
+    size_t                    maxEntries,
+    size_t                    maxBytes,
+    unsigned                  quotaPercent,
+    std::chrono::milliseconds flightWait
+) {
+    mFlightWaitMs.store(std::max<int64_t>(flightWait.count(), 0), std::memory_order_relaxed);
+    if (maxBytes == 0) {
+        maxEntries = 0;
+    }
+    mMaxEntries.store(maxEntries, std::memory_order_relaxed);
+    mMaxBytes.store(maxEntries ? maxBytes : 0, std::memory_order_relaxed);
+
+    // 上限按分片均分；窗口约占 1%，主区中保护段占 80%
+    const size_t capacity = (maxEntries + kShardCount - 1) / kShardCount;
+    for (Shard& shard : mShards) {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        shard.capacity          = capacity;
+        shard.windowCapacity    = capacity ? std::max<size_t>(capacity / 100, 1) : 0;
+        shard.protectedCapacity = (capacity - shard.windowCapacity) * 4 / 5;
+        shard.maxBytes          = capacity ? (maxBytes + kShardCount - 1) / kShardCount : 0;
+        shard.quota             = quotaPercent == 0 || quotaPercent >= 100
+                                    ? SIZE_MAX
+                                    : std::max<size_t>(capacity * quotaPercent / 100, 1);
+        shard.sketch.resize(capacity);
+
+        while (shard.protectedList.size() > shard.protectedCapacity) {
+            Node& demoted = *shard.protectedList.back();
+            shard.probation.splice(shard.probation.begin(), shard.protectedList, demoted.regionPos);
+            demoted.region = Region::Probation;
+        }
+        enforceLimits(shard, nullptr);
+        resizeBuckets(shard, std::bit_ceil(std::max<size_t>(capacity, 1)));
+
+        RetiredList retired = takeRetired(shard, true);
+        lock.unlock();
+        retire(std::move(retired));
+    }
+    mEpoch.store(gNextEpoch.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+}
+
+uint64_t PlaceholderCacheStore::allocate(unsigned int ttlSeconds, uint32_t flags, Refresher refresher) {
+    const uint64_t id = mNextId.fetch_add(1, std::memory_order_relaxed);
+
+    Policy policy;
+    policy.ttlSeconds = ttlSeconds;
+    policy.flags      = flags & kCacheSingleFlight;
+    if (refresher) {
+        policy.flags     = flags;
+        policy.refresher = std::make_shared<const Refresher>(std::move(refresher));
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mIdsMutex);
+    mPolicies.emplace(id, std::move(policy));
+    return id;
+}
+
+void PlaceholderCacheStore::release(uint64_t id) {
+    {
+        std::unique_lock<std::shared_mutex> lock(mIdsMutex);
+        if (!mPolicies.erase(id)) {
+            return;
+        }
+    }
+    // 此后 put 不会再为该 id 写入，可逐个分片清理
+    for (Shard& shard : mShards) {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        auto                         owner = shard.owners.find(id);
+        if (owner == shard.owners.end()) {
+            continue;
+        }
+        std::vector<Node*> nodes(owner->second.begin(), owner->second.end());
+        for (Node* node : nodes) {
+            erase(shard, *node);
+        }
+
+        RetiredList retired = takeRetired(shard, true);
+        lock.unlock();
+        retire(std::move(retired));
+    }
+}
+
+size_t PlaceholderCacheStore::invalidateInstance(uint64_t instanceId) {
+    if (instanceId == 0) {
+        return 0;
+    }
+
+    // 同一实例的条目按 key 哈希分散在各分片，每个分片只需一次索引查找
+    size_t removed = 0;
+    for (Shard& shard : mShards) {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        auto                         instance = shard.instances.find(instanceId);
+        if (instance == shard.instances.end()) {
+            continue;
+        }
+        std::vector<Node*> nodes(instance->second.begin(), instance->second.end());
+        for (Node* node : nodes) {
+            erase(shard, *node);
+        }
+        removed += nodes.size();
+
+        RetiredList retired = takeRetired(shard, true);
+        lock.unlock();
+        retire(std::move(retired));
+    }
+    mInvalidations.fetch_add(removed, std::memory_order_relaxed);
+    return removed;
+}
+
+bool PlaceholderCacheStore::get(uint64_t id, const PlaceholderCacheKey& key, std::string& out) {
+    const auto now = std::chrono::steady_clock::now();
+    advanceTimers(now);
+
+    const LookupKey lookup = lookupOf(id, key);
+    Shard&          shard  = shardFor(lookup.hash);
+    const uint64_t  epoch  = mEpoch.load(std::memory_order_acquire);
+
+    // L1：槽位写入后该分片没有任何修改、且未超过有效期时，其中的值与共享缓存一致
+    LocalSlot& local = localSlot(lookup.hash);
+    if (local.epoch == epoch && local.blob && local.blob->matches(lookup) && now < local.validUntil
+        && local.generation == shard.generation.load(std::memory_order_acquire)) {
+        mLocalHits.add();
+        out = local.blob->value;
+        return true;
+    }
+
+    // 先于查找读取修改计数：查找期间发生的写入会让之后的 L1 校验失败，而不会把旧值当作新值
+    const uint64_t generation = shard.generation.load(std::memory_order_acquire);
+
+    std::optional<StoredKey> refresh;
+    {
+        EpochDomain::Guard guard;
+        const ValueBlob*   blob = findBlob(shard, lookup);
+        if (!blob) {
+            mMisses.add();
+            recordRead(shard, lookup.hash, 0);
+            return false;
+        }
+
+        if (now < blob->expiresAt) {
+            if (!blob->hot.load(std::memory_order_relaxed)) {
+                blob->hot.store(true, std::memory_order_relaxed);
+            }
+            mHits.add();
+            out = blob->value;
+
+            local.epoch      = epoch;
+            local.generation = generation;
+            local.validUntil = std::min(blob->expiresAt, now + kLocalLifetime);
+            local.blob       = blob->shared_from_this();
+            recordRead(shard, lookup.hash, blob->serial);
+            return true;
+        }
+        if (now >= blob->staleUntil || !mHasExecutor.load(std::memory_order_acquire)) {
+            mMisses.add();
+            recordRead(shard, lookup.hash, 0);
+            return false; // 过期条目保留在原位，随后的 put 会原地刷新
+        }
+
+        // stale-while-revalidate：返回旧值，只有第一个发现过期的读者发起刷新
+        mStaleHits.add();
+        out = blob->value;
+        recordRead(shard, lookup.hash, 0);
+        if (!blob->refreshing.exchange(true, std::memory_order_acq_rel)) {
+            refresh = StoredKey{blob->id, blob->instanceId, blob->hash, blob->args, blob->instanceKey};
+        }
+    }
+    if (refresh) {
+        submitRefresh(std::move(*refresh));
+    }
+    return true;
+}
+
+void PlaceholderCacheStore::put(uint64_t id, const PlaceholderCacheKey& key, const std::string& value) {
+    advanceTimers(std::chrono::steady_clock::now());
+    write(lookupOf(id, key), value);
+}
+
+bool PlaceholderCacheStore::joinOrLead(
+    uint64_t id, const PlaceholderCacheKey& key, std::string& out, FlightLease& lease
+) {
+    {
+        std::shared_lock<std::shared_mutex> idsLock(mIdsMutex);
+        auto                                policy = mPolicies.find(id);
+        if (policy == mPolicies.end() || !(policy->second.flags & kCacheSingleFlight)) {
+            return false;
+        }
+    }
+
+    const LookupKey lookup = lookupOf(id, key);
+    Shard&          shard  = shardFor(lookup.hash);
+
+    std::shared_ptr<Flight> flight;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto                        it = shard.flights.find(lookup);
+        if (it == shard.flights.end()) {
+            // 领头者先写入缓存、再摘除在途记录：这里没有在途记录时，刚结束的求值结果必然已在缓存中
+            auto cached = shard.index.find(lookup);
+            if (cached != shard.index.end() && std::chrono::steady_clock::now() < cached->second.blob->expiresAt) {
+                touch(shard, cached->second);
+                mCoalesced.fetch_add(1, std::memory_order_relaxed);
+                out = cached->second.blob->value;
+                return true;
+            }
+
+            auto [pos, inserted] = shard.flights.emplace(
+                StoredKey{
+                    lookup.id,
+                    lookup.instanceId,
+                    lookup.hash,
+                    std::string(lookup.args),
+                    std::string(lookup.instanceKey)
+                },
+                std::make_shared<Flight>()
+            );
+            pos->second->key    = &pos->first;
+            pos->second->leader = std::this_thread::get_id();
+            lease               = FlightLease();
+            lease.mStore        = this;
+            lease.mFlight       = pos->second;
+            return false;
+        }
+        flight = it->second;
+    }
+
+    // 同一线程在求值过程中再次渲染同一 key（嵌套占位符）时不能等待自己
+    if (flight->leader == std::this_thread::get_id()) {
+        return false;
+    }
+
+    mFlightWaits.fetch_add(1, std::memory_order_relaxed);
+    const std::chrono::milliseconds wait(mFlightWaitMs.load(std::memory_order_relaxed));
+    std::unique_lock<std::mutex>    lock(flight->mutex);
+    if (!flight->done.wait_for(lock, wait, [&] { return flight->finished; }) || !flight->succeeded) {
+        mFlightFallbacks.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    mCoalesced.fetch_add(1, std::memory_order_relaxed);
+    out = flight->value;
+    return true;
+}
+
+void PlaceholderCacheStore::write(const LookupKey& lookup, const std::string& value) {
+    Shard& shard = shardFor(lookup.hash);
+
+    RetiredList retired;
+    {
+        std::shared_lock<std::shared_mutex> idsLock(mIdsMutex);
+        auto                                policy = mPolicies.find(lookup.id);
+        if (policy == mPolicies.end()) {
+            return; // 已释放：例如占位符反注册后仍在旧快照上完成的渲染
+        }
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.capacity == 0) {
+            return;
+        }
+        drainReads(shard); // 之前未命中的读记录先计入频率，准入比较才看得到
+
+        auto it = shard.index.find(lookup);
+        if (it != shard.index.end()) {
+            Node& node   = it->second;
+            shard.bytes -= node.bytes;
+            assign(shard, node, value, policy->second);
+            shard.bytes += node.bytes;
+            enforceLimits(shard, &node);
+        } else {
+            insert(shard, lookup, value, policy->second);
+        }
+        retired = takeRetired(shard, false);
+    }
+    retire(std::move(retired));
+}
+
+void PlaceholderCacheStore::assign(Shard& shard, Node& node, const std::string& value, const Policy& policy) {
+    const auto now = std::chrono::steady_clock::now();
+    const auto ttl = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::seconds(policy.ttlSeconds)
+    );
+
+    // 每次写入发布一个新 blob，正在读取旧值的读者不受影响
+    auto blob         = std::make_shared<ValueBlob>();
+    blob->id          = node.key->id;
+    blob->instanceId  = node.key->instanceId;
+    blob->hash        = node.key->hash;
+    blob->args        = node.key->args;
+    blob->instanceKey = node.key->instanceKey;
+    blob->value       = value;
+    blob->expiresAt   = now + ttl;
+    blob->staleUntil  = policy.flags & kCacheStaleWhileRevalidate ? blob->expiresAt + ttl : blob->expiresAt;
+    blob->serial      = mNextSerial.fetch_add(1, std::memory_order_relaxed);
+    node.bytes        = (node.key->args.size() + node.key->instanceKey.size()) * 2 + value.size() + kEntryOverhead;
+
+    const auto     expiresAt  = blob->expiresAt;
+    const auto     staleUntil = blob->staleUntil;
+    const uint64_t serial     = blob->serial;
+    publish(shard, node, std::move(blob));
+
+    // 调用方持有分片锁；加锁顺序固定为 分片 -> 时间轮
+    std::lock_guard<std::mutex> lock(mTimersMutex);
+    if (policy.flags & kCacheRefreshAhead) {
+        const auto refreshAt = expiresAt - refreshAheadMargin(ttl);
+        mTimers.schedule(refreshAt, Timer{*node.key, serial, TimerKind::RefreshAhead});
+    }
+    mTimers.schedule(staleUntil, Timer{*node.key, serial, TimerKind::Expire});
+}
+
+void PlaceholderCacheStore::setExecutor(CacheExecutor executor) {
+    std::lock_guard<std::mutex> lock(mExecutorMutex);
+    mHasExecutor.store(static_cast<bool>(executor), std::memory_order_release);
+    mExecutor = std::move(executor);
+}
+
+void PlaceholderCacheStore::advanceTimers(std::chrono::steady_clock::time_point now) {
+    if (now.time_since_epoch().count() < mNextTickAt.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    std::vector<Timer> due;
+    {
+        std::unique_lock<std::mutex> lock(mTimersMutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return; // 其他线程正在推进
+        }
+        mTimers.advance(now, due);
+        mNextTickAt.store(mTimers.nextTickAt().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    for (const Timer& timer : due) {
+        fireTimer(timer);
+    }
+}
+
+void PlaceholderCacheStore::fireTimer(const Timer& timer) {
+    Shard& shard = shardFor(timer.key.hash);
+
+    std::optional<StoredKey> refresh;
+    RetiredList              retired;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto                        it = shard.index.find(lookupOf(timer.key));
+        if (it == shard.index.end() || it->second.blob->serial != timer.serial) {
+            return; // 已被覆盖、淘汰或释放
+        }
+
+        Node&            node = it->second;
+        const ValueBlob& blob = *node.blob;
+        if (timer.kind == TimerKind::Expire) {
+            if (!blob.refreshing.load(std::memory_order_acquire)) {
+                erase(shard, node);
+                mExpirations.fetch_add(1, std::memory_order_relaxed);
+                retired = takeRetired(shard, false);
+            }
+        } else if (blob.hot.load(std::memory_order_relaxed) && mHasExecutor.load(std::memory_order_acquire)
+                   && !blob.refreshing.exchange(true, std::memory_order_acq_rel)) {
+            // 只提前刷新本周期内被读取过的值，冷门参数组合到期后直接回收
+            refresh = *node.key;
+        }
+    }
+    retire(std::move(retired));
+    if (refresh) {
+        submitRefresh(std::move(*refresh));
+    }
+}
+
+void PlaceholderCacheStore::submitRefresh(StoredKey key) {
+    CacheExecutor executor;
+    {
+        std::lock_guard<std::mutex> lock(mExecutorMutex);
+        executor = mExecutor;
+    }
+    std::shared_ptr<const Refresher> refresher;
+    {
+        std::shared_lock<std::shared_mutex> lock(mIdsMutex);
+        auto                                policy = mPolicies.find(key.id);
+        if (policy != mPolicies.end()) {
+            refresher = policy->second.refresher;
+        }
+    }
+    if (!executor || !refresher) {
+        cancelRefresh(key);
+        return;
+    }
+
+    mRefreshes.fetch_add(1, std::memory_order_relaxed);
+    executor([this, key = std::move(key), refresher = std::move(refresher)]() {
+        std::string value;
+        try {
+            (*refresher)(key.args, value);
+        } catch (...) {
+            cancelRefresh(key); // 保留旧值，下一个发现过期的读者会再次尝试
+            return;
+        }
+        write(lookupOf(key), value);
+    });
+}
+
+void PlaceholderCacheStore::cancelRefresh(const StoredKey& key) {
+    Shard& shard = shardFor(key.hash);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto                        it = shard.index.find(lookupOf(key));
+    if (it != shard.index.end()) {
+        it->second.blob->refreshing.store(false, std::memory_order_release);
+    }
+}
+
+void PlaceholderCacheStore::insert(
+    Shard&             shard,
+    const LookupKey&   key,
+    const std::string& value,
+    const Policy&      policy
+) {
+    // 配额已满时先淘汰该占位符自己最久未用的值，不参与与其他占位符的竞争
+    auto owner = shard.owners.find(key.id);
+    if (owner != shard.owners.end() && owner->second.size() >= shard.quota) {
+        erase(shard, *owner->second.back());
+        mQuotaEvictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    StoredKey stored{key.id, key.instanceId, key.hash, std::string(key.args), std::string(key.instanceKey)};
+    auto      it    = shard.index.try_emplace(std::move(stored)).first;
+    NodeList& owned = shard.owners[key.id];
+    Node&     node  = it->second;
+
+    node.key       = &it->first;
+    node.region    = Region::Window;
+    node.regionPos = shard.window.insert(shard.window.begin(), &node);
+    node.ownerPos  = owned.insert(owned.begin(), &node);
+    if (key.instanceId != 0) {
+        // 服务器级与空上下文的值不属于任何实例，不进入实例索引
+        NodeList& instance = shard.instances[key.instanceId];
+        node.instancePos   = instance.insert(instance.begin(), &node);
+    }
+    assign(shard, node, value, policy);
+    shard.bytes      += node.bytes;
+
+    enforceLimits(shard, nullptr);
+}
+
+PlaceholderCacheStore::NodeList& PlaceholderCacheStore::listFor(Shard& shard, Region region) {
+    switch (region) {
+    case Region::Window:
+        return shard.window;
+    case Region::Probation:
+        return shard.probation;
+    default:
+        return shard.protectedList;
+    }
+}
+
+void PlaceholderCacheStore::touch(Shard& shard, Node& node) {
+    NodeList& owned = shard.owners[node.key->id];
+    owned.splice(owned.begin(), owned, node.ownerPos);
+
+    if (node.region != Region::Probation) {
+        NodeList& list = listFor(shard, node.region);
+        list.splice(list.begin(), list, node.regionPos);
+        return;
+    }
+
+    // 试用段再次命中即晋升保护段；保护段溢出的条目降回试用段头部
+    shard.protectedList.splice(shard.protectedList.begin(), shard.probation, node.regionPos);
+    node.region = Region::Protected;
+    if (shard.protectedList.size() > shard.protectedCapacity) {
+        Node& demoted = *shard.protectedList.back();
+        shard.probation.splice(shard.probation.begin(), shard.protectedList, demoted.regionPos);
+        demoted.region = Region::Probation;
+    }
+}
+
+PlaceholderCacheStore::Node* PlaceholderCacheStore::mainVictim(Shard& shard, const Node* exclude) {
+    for (NodeList* list : {&shard.probation, &shard.protectedList}) {
+        for (auto it = list->rbegin(); it != list->rend(); ++it) {
+            if (*it != exclude) {
+                return *it;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void PlaceholderCacheStore::admitFromWindow(Shard& shard) {
+    while (shard.window.size() > shard.windowCapacity) {
+        Node& candidate = *shard.window.back();
+        shard.probation.splice(shard.probation.begin(), shard.window, candidate.regionPos);
+        candidate.region = Region::Probation;
+
+        const size_t mainCapacity = shard.capacity - shard.windowCapacity;
+        if (shard.probation.size() + shard.protectedList.size() <= mainCapacity) {
+            continue;
+        }
+        // 主区已满：候选与主区最久未用的条目比较访问频率，频率不高于对方的候选直接丢弃
+        Node* victim = mainVictim(shard, &candidate);
+        if (victim
+            && shard.sketch.estimate(candidate.key->hash) > shard.sketch.estimate(victim->key->hash)) {
+            erase(shard, *victim);
+            mEvictions.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            erase(shard, candidate);
+            mRejections.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void PlaceholderCacheStore::enforceLimits(Shard& shard, const Node* keep) {
+    // 条目数：先让窗口溢出部分经过准入，再直接淘汰主区多余的条目（仅在上限被调小时发生）
+    admitFromWindow(shard);
+    while (shard.probation.size() + shard.protectedList.size() > shard.capacity - shard.windowCapacity) {
+        erase(shard, *mainVictim(shard, nullptr));
+        mEvictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 字节数：依次从试用段、保护段、窗口的尾部淘汰；刚写入的条目最后才考虑
+    while (shard.bytes > shard.maxBytes) {
+        Node* victim = mainVictim(shard, keep);
+        if (!victim) {
+            for (auto it = shard.window.rbegin(); it != shard.window.rend(); ++it) {
+                if (*it != keep) {
+                    victim = *it;
+                    break;
+                }
+            }
+        }
+        if (!victim) {
+            victim = const_cast<Node*>(keep); // 单条值超过分片字节上限
+            keep   = nullptr;
+        }
+        if (!victim) {
+            break;
+        }
+        erase(shard, *victim);
+        mEvictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void PlaceholderCacheStore::erase(Shard& shard, Node& node) {
+    unpublish(shard, node);
+    listFor(shard, node.region).erase(node.regionPos);
+
+    auto owner = shard.owners.find(node.key->id);
+    owner->second.erase(node.ownerPos);
+    if (owner->second.empty()) {
+        shard.owners.erase(owner);
+    }
+
+    if (node.key->instanceId != 0) {
+        auto instance = shard.instances.find(node.key->instanceId);
+        instance->second.erase(node.instancePos);
+        if (instance->second.empty()) {
+            shard.instances.erase(instance);
+        }
+    }
+
+    shard.bytes -= node.bytes;
+    shard.index.erase(shard.index.find(*node.key));
+}
+
+// ========== 无锁读索引 ==========
+
+const PlaceholderCacheStore::ValueBlob* PlaceholderCacheStore::findBlob(const Shard& shard, const LookupKey& key) {
+    const Buckets*   table = shard.buckets.load(std::memory_order_acquire);
+    const ValueBlob* blob  = table->heads[key.hash & table->mask].load(std::memory_order_acquire);
+    for (; blob; blob = blob->next.load(std::memory_order_acquire)) {
+        if (blob->matches(key)) {
+            return blob;
+        }
+    }
+    return nullptr;
+}
+
+void PlaceholderCacheStore::publish(Shard& shard, Node& node, BlobRef blob) {
+    std::atomic<const ValueBlob*>* link = &shard.table->heads[blob->hash & shard.table->mask];
+    if (node.blob) {
+        // 原位替换：新 blob 接管旧 blob 的后继，仍停在旧 blob 上的读者照常沿旧链走完
+        while (link->load(std::memory_order_relaxed) != node.blob.get()) {
+            link = &link->load(std::memory_order_relaxed)->next;
+        }
+        blob->next.store(node.blob->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        shard.serials.erase(node.blob->serial);
+        shard.retired.push_back(std::move(node.blob));
+    } else {
+        blob->next.store(link->load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    shard.serials[blob->serial] = &node;
+    link->store(blob.get(), std::memory_order_release);
+    node.blob = std::move(blob);
+    shard.generation.fetch_add(1, std::memory_order_release);
+}
+
+void PlaceholderCacheStore::unpublish(Shard& shard, Node& node) {
+    std::atomic<const ValueBlob*>* link = &shard.table->heads[node.blob->hash & shard.table->mask];
+    while (link->load(std::memory_order_relaxed) != node.blob.get()) {
+        link = &link->load(std::memory_order_relaxed)->next;
+    }
+    link->store(node.blob->next.load(std::memory_order_relaxed), std::memory_order_release);
+    shard.serials.erase(node.blob->serial);
+    shard.retired.push_back(std::move(node.blob));
+    shard.generation.fetch_add(1, std::memory_order_release);
+}
+
+void PlaceholderCacheStore::resizeBuckets(Shard& shard, size_t count) {
+    if (shard.table && shard.table->mask + 1 == count) {
+        return;
+    }
+
+    // 链指针不能在读者脚下改动，因此把每个值复制一份挂到新数组上，旧数组与旧 blob 一并延迟回收；只在重新配置时发生
+    auto table = std::make_shared<Buckets>(count);
+    for (auto& [key, node] : shard.index) {
+        auto clone         = std::make_shared<ValueBlob>();
+        clone->id          = node.blob->id;
+        clone->instanceId  = node.blob->instanceId;
+        clone->hash        = node.blob->hash;
+        clone->args        = node.blob->args;
+        clone->instanceKey = node.blob->instanceKey;
+        clone->value       = node.blob->value;
+        clone->expiresAt   = node.blob->expiresAt;
+        clone->staleUntil  = node.blob->staleUntil;
+        clone->serial      = node.blob->serial;
+        clone->hot.store(node.blob->hot.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        clone->refreshing.store(node.blob->refreshing.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        auto& head = table->heads[clone->hash & table->mask];
+        clone->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        head.store(clone.get(), std::memory_order_relaxed);
+        shard.retired.push_back(std::exchange(node.blob, std::move(clone)));
+    }
+
+    shard.buckets.store(table.get(), std::memory_order_release);
+    if (shard.table) {
+        shard.retired.push_back(std::move(shard.table));
+    }
+    shard.table = std::move(table);
+    shard.generation.fetch_add(1, std::memory_order_release);
+}
+
+PlaceholderCacheStore::RetiredList PlaceholderCacheStore::takeRetired(Shard& shard, bool force) {
+    if (shard.retired.empty() || (!force && shard.retired.size() < kRetireBatch)) {
+        return {};
+    }
+    return std::exchange(shard.retired, {});
+}
+
+void PlaceholderCacheStore::retire(RetiredList retired) {
+    if (retired.empty()) {
+        return;
+    }
+    EpochDomain::global().retire([retired = std::move(retired)]() mutable { retired.clear(); });
+}
+
+// ========== 读缓冲 ==========
+
+void PlaceholderCacheStore::recordRead(Shard& shard, uint64_t hash, uint64_t serial) {
+    thread_local uint32_t cursor = 0;
+
+    ReadStripe& stripe = shard.reads[localStripe() % kReadStripes];
+    ReadSlot&   slot   = stripe.slots[cursor++ % kReadSlots];
+    slot.serial.store(serial, std::memory_order_relaxed);
+    slot.hash.store(hash ? hash : 1, std::memory_order_release);
+
+    // 每写满一轮尝试回放本条带；分片正忙时放弃，之后的记录直接覆盖
+    if (cursor % kReadSlots == 0) {
+        std::unique_lock<std::mutex> lock(shard.mutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            drainStripe(shard, stripe);
+        }
+    }
+}
+
+void PlaceholderCacheStore::drainReads(Shard& shard) {
+    for (ReadStripe& stripe : shard.reads) {
+        drainStripe(shard, stripe);
+    }
+}
+
+void PlaceholderCacheStore::drainStripe(Shard& shard, ReadStripe& stripe) {
+    for (ReadSlot& slot : stripe.slots) {
+        const uint64_t hash = slot.hash.exchange(0, std::memory_order_acquire);
+        if (hash == 0) {
+            continue;
+        }
+        shard.sketch.increment(hash);
+
+        // 序号不在索引中说明该值已被覆盖或淘汰，只计频率
+        const uint64_t serial = slot.serial.load(std::memory_order_relaxed);
+        auto           it     = serial ? shard.serials.find(serial) : shard.serials.end();
+        if (it != shard.serials.end()) {
+            touch(shard, *it->second);
+        }
+    }
+}
+
+// ========== FlightLease ==========
+
+PlaceholderCacheStore::FlightLease::FlightLease(FlightLease&& other) noexcept
+: mStore(std::exchange(other.mStore, nullptr)),
+  mFlight(std::move(other.mFlight)) {}
+
+PlaceholderCacheStore::FlightLease& PlaceholderCacheStore::FlightLease::operator=(FlightLease&& other) noexcept {
+    if (this != &other) {
+        finish(nullptr);
+        mStore  = std::exchange(other.mStore, nullptr);
+        mFlight = std::move(other.mFlight);
+    }
+    return *this;
+}
+
+PlaceholderCacheStore::FlightLease::~FlightLease() { finish(nullptr); }
+
+void PlaceholderCacheStore::FlightLease::complete(const std::string& value) { finish(&value); }
+
+void PlaceholderCacheStore::FlightLease::finish(const std::string* value) {
+    if (!mFlight) {
+        return;
+    }
+    std::shared_ptr<Flight> flight = std::move(mFlight);
+
+    // 先摘除在途记录，之后到达的未命中直接读缓存或成为新的领头者
+    Shard& shard = mStore->shardFor(flight->key->hash);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.flights.erase(shard.flights.find(lookupOf(*flight->key)));
+    }
+    {
+        std::lock_guard<std::mutex> lock(flight->mutex);
+        flight->key      = nullptr;
+        flight->finished = true;
+        if (value) {
+            flight->succeeded = true;
+            flight->value     = *value;
+        }
+    }
+    flight->done.notify_all();
+}
+
+ValueCacheStats PlaceholderCacheStore::stats() const {
+    ValueCacheStats result;
+    result.hits            = mHits.load();
+    result.localHits       = mLocalHits.load();
+    result.misses          = mMisses.load();
+    result.evictions       = mEvictions.load(std::memory_order_relaxed);
+    result.rejections      = mRejections.load(std::memory_order_relaxed);
+    result.quotaEvictions  = mQuotaEvictions.load(std::memory_order_relaxed);
+    result.invalidations   = mInvalidations.load(std::memory_order_relaxed);
+    result.expirations     = mExpirations.load(std::memory_order_relaxed);
+    result.staleHits       = mStaleHits.load();
+    result.refreshes       = mRefreshes.load(std::memory_order_relaxed);
+    result.flightWaits     = mFlightWaits.load(std::memory_order_relaxed);
+    result.coalesced       = mCoalesced.load(std::memory_order_relaxed);
+    result.flightFallbacks = mFlightFallbacks.load(std::memory_order_relaxed);
+    result.capacity        = mMaxEntries.load(std::memory_order_relaxed);
+    result.byteCapacity    = mMaxBytes.load(std::memory_order_relaxed);
+    for (const Shard& shard : mShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        result.size  += shard.index.size();
+        result.bytes += shard.bytes;
+    }
+    return result;
+}
+
+size_t PlaceholderCacheStore::slotCount() const {
+    std::shared_lock<std::shared_mutex> lock(mIdsMutex);
+    return mPolicies.size();
+}
+
+size_t PlaceholderCacheStore::valueCount() const {
+    size_t count = 0;
+    for (const Shard& shard : mShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.index.size();
+    }
+    return count;
+}
+
+} // namespace PA
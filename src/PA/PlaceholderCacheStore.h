@@ -0,0 +1,427 @@
+// src/PA/PlaceholderCacheStore.h
+#pragma once
+
+#include "PA/PlaceholderAPI.h"
+#include "PA/TimingWheel.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace PA {
+
+/**
+ * @brief 缓存值的定长 key：上下文实例 id + 缓存参数
+ * 组合哈希在构造时算好一次，查找与写入共用；参数原文只在哈希相同时用于比较，不参与分配。
+ * instanceKey 为实例 id 取自哈希时的实例键原文（见 ContextInstanceKey），与参数分开保存和比较，
+ * 参数始终是占位符收到的原样内容，后台刷新可以直接用它重新求值。
+ */
+struct PlaceholderCacheKey {
+    uint64_t         instanceId{};
+    std::string_view args;
+    std::string_view instanceKey;
+    uint64_t         hash{};
+
+    PlaceholderCacheKey(uint64_t instance, std::string_view cacheArgs, std::string_view exactInstanceKey = {}) noexcept
+    : instanceId(instance),
+      args(cacheArgs),
+      instanceKey(exactInstanceKey),
+      hash(combine(instance, cacheArgs.empty() ? 0 : std::hash<std::string_view>{}(cacheArgs))) {}
+
+    static uint64_t combine(uint64_t instance, uint64_t argsHash) noexcept {
+        uint64_t h  = instance ^ (argsHash + 0x9e3779b97f4a7c15ull + (instance << 6) + (instance >> 2));
+        h          ^= h >> 33;
+        h          *= 0xff51afd7ed558ccdull;
+        h          ^= h >> 33;
+        return h;
+    }
+};
+
+/**
+ * @brief 缓存占位符的值存储
+ * 独立于注册表快照长期存在，以注册时分配的稳定 id 区分占位符；快照只持有指向它的指针，
+ * 发布新快照不会复制、丢弃或重复任何缓存值，仍被渲染持有的旧快照写入的值对新快照同样可见。
+ *
+ * 所有占位符共享同一组条目数与字节数上限，按 key 哈希分片、各分片独立加锁。淘汰采用 W-TinyLFU：
+ * 新值先进入很小的窗口 LRU，被挤出窗口时与主区（试用段 + 保护段的分段 LRU）的淘汰候选比较 Count-Min 估算的访问频率，
+ * 频率高者留下，因此路过的生物、一次性坐标等只出现一两次的 key 挤不掉常用值。
+ * 每个占位符在每个分片内最多占用 quotaPercent% 的条目，超出时先淘汰它自己最久未用的值，单个嘈杂的 token 不会清空其他缓存。
+ *
+ * 读取不加锁：每个值发布为不可变、带引用计数的 ValueBlob，挂在分片的无锁桶链上，读者在 EpochDomain 临界区内查找并复制，
+ * 写者（按分片加锁，即 16 路条带）以新 blob 原子替换旧 blob，旧 blob 批量交给 EpochDomain 延迟回收，
+ * 因此读者从不等待正在写入大字符串的写者。读取对 LRU 与访问频率的影响先记入分片的有损读缓冲，由写者或缓冲写满的读者顺带回放。
+ *
+ * 共享缓存之前还有一层线程本地的直接映射 L1：命中共享缓存的 blob 由当前线程的槽位持有一份引用，
+ * 之后约一个游戏刻内的重复读取只需校验 store 的 epoch、分片的修改计数与过期时间，不进入临界区也不写共享状态。
+ */
+class PlaceholderCacheStore {
+    struct Flight;
+
+public:
+    static constexpr size_t                    kDefaultMaxEntries   = 65536;
+    static constexpr size_t                    kDefaultMaxBytes     = size_t{64} << 20;
+    static constexpr unsigned                  kDefaultQuotaPercent = 25;
+    static constexpr std::chrono::milliseconds kDefaultFlightWait{100};
+
+    explicit PlaceholderCacheStore(
+        size_t                    maxEntries   = kDefaultMaxEntries,
+        size_t                    maxBytes     = kDefaultMaxBytes,
+        unsigned                  quotaPercent = kDefaultQuotaPercent,
+        std::chrono::milliseconds flightWait   = kDefaultFlightWait
+    );
+
+    PlaceholderCacheStore(const PlaceholderCacheStore&)            = delete;
+    PlaceholderCacheStore& operator=(const PlaceholderCacheStore&) = delete;
+
+    // 调整上限，超出部分立即淘汰；maxEntries 或 maxBytes 为 0 时禁用缓存；quotaPercent 为 0 或不小于 100 时不限配额；
+    // flightWait 为单飞等待者最多等待领头求值的时长
+    void configure(
+        size_t                    maxEntries,
+        size_t                    maxBytes,
+        unsigned                  quotaPercent,
+        std::chrono::milliseconds flightWait = kDefaultFlightWait
+    );
+
+    /**
+     * @brief 单飞求值的领头凭证
+     * 持有者负责求值、写入缓存后调用 complete() 把结果交给等待者；未调用即析构（如求值抛出异常）时放弃本次求值，
+     * 等待者各自回退为自行求值。
+     */
+    class FlightLease {
+    public:
+        FlightLease() = default;
+        FlightLease(FlightLease&& other) noexcept;
+        FlightLease& operator=(FlightLease&& other) noexcept;
+        ~FlightLease();
+
+        bool leading() const noexcept { return static_cast<bool>(mFlight); }
+        void complete(const std::string& value);
+
+    private:
+        friend class PlaceholderCacheStore;
+
+        void finish(const std::string* value);
+
+        PlaceholderCacheStore*  mStore{};
+        std::shared_ptr<Flight> mFlight;
+    };
+
+    // 按缓存参数重新求值的函数，用于后台刷新；只有服务器级占位符能脱离渲染上下文求值，因此仅它们提供
+    using Refresher = std::function<void(std::string_view cacheArgs, std::string& out)>;
+
+    // 为新注册的缓存占位符分配 id；flags 为 CacheFlags，refresher 为空时只保留其中的单飞策略
+    uint64_t allocate(unsigned int ttlSeconds, uint32_t flags = 0, Refresher refresher = {});
+
+    // 释放 id 及其全部缓存值；之后对该 id 的读写均被忽略
+    void release(uint64_t id);
+
+    /**
+     * @brief 读取未过期的缓存值，不加锁
+     * 开启 stale-while-revalidate 且设置了执行器时，过期后的一个缓存周期内仍返回旧值，并只发起一次后台刷新。
+     * 由线程本地 L1 回答的读取不计入访问频率与 LRU 顺序，其余读取无论是否命中都经有损读缓冲计入，高并发时可能丢弃少量记录。
+     */
+    bool get(uint64_t id, const PlaceholderCacheKey& key, std::string& out);
+
+    void put(uint64_t id, const PlaceholderCacheKey& key, const std::string& value);
+
+    /**
+     * @brief 未命中后的单飞协调，仅对开启 kCacheSingleFlight 的 id 生效
+     * 同一 key 已有其他线程在求值时等待其结果（最多 flightWait），拿到结果写入 out 并返回 true；
+     * 否则返回 false，调用方自行求值：若 lease.leading() 则本线程成为领头者，求值并 put 后须调用 lease.complete()。
+     */
+    bool joinOrLead(uint64_t id, const PlaceholderCacheKey& key, std::string& out, FlightLease& lease);
+
+    // 设置后台刷新使用的执行器；为空时停用 refresh-ahead 与 stale-while-revalidate
+    void setExecutor(CacheExecutor executor);
+
+    // 移除所有占位符中属于该上下文实例的缓存值，开销与该实例的条目数成正比；返回移除的条目数。
+    // instanceId 为 0 的条目（服务器级或空上下文）不进入实例索引，传入 0 时什么也不做
+    size_t invalidateInstance(uint64_t instanceId);
+
+    ValueCacheStats stats() const;
+
+    // 当前存活的 id 数与缓存值总数
+    size_t slotCount() const;
+    size_t valueCount() const;
+
+private:
+    enum class Region : uint8_t { Window, Probation, Protected };
+
+    struct StoredKey {
+        uint64_t    id{};
+        uint64_t    instanceId{};
+        uint64_t    hash{}; // id 与 PlaceholderCacheKey::hash 的组合
+        std::string args;
+        std::string instanceKey;
+    };
+
+    // 查找用 key：与 StoredKey 异构比较，查找时无需复制参数
+    struct LookupKey {
+        uint64_t         id{};
+        uint64_t         instanceId{};
+        uint64_t         hash{};
+        std::string_view args;
+        std::string_view instanceKey;
+    };
+
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(const StoredKey& key) const noexcept { return static_cast<size_t>(key.hash); }
+        size_t operator()(const LookupKey& key) const noexcept { return static_cast<size_t>(key.hash); }
+    };
+
+    struct KeyEqual {
+        using is_transparent = void;
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const noexcept {
+            return a.hash == b.hash && a.id == b.id && a.instanceId == b.instanceId
+                && std::string_view(a.args) == std::string_view(b.args)
+                && std::string_view(a.instanceKey) == std::string_view(b.instanceKey);
+        }
+    };
+
+    /**
+     * @brief 一次写入发布的缓存值
+     * 除两个状态标志与桶链指针外发布后不再修改；摘除后交给 EpochDomain 回收，L1 槽位另持有引用时活得更久。
+     */
+    struct ValueBlob : std::enable_shared_from_this<ValueBlob> {
+        uint64_t                              id{};
+        uint64_t                              instanceId{};
+        uint64_t                              hash{};
+        std::string                           args;
+        std::string                           instanceKey;
+        std::string                           value;
+        std::chrono::steady_clock::time_point expiresAt;
+        std::chrono::steady_clock::time_point staleUntil;   // 未开启 stale-while-revalidate 时等于 expiresAt
+        uint64_t                              serial{};     // 每次写入递增，用于识别过时的定时器与读记录
+        mutable std::atomic<bool>             hot{};        // 本次写入后是否被读取过
+        mutable std::atomic<bool>             refreshing{}; // 已有后台刷新在途
+        mutable std::atomic<const ValueBlob*> next{};       // 同一桶内的下一个值，只由持有分片锁的写者修改
+
+        bool matches(const LookupKey& key) const noexcept {
+            return hash == key.hash && id == key.id && instanceId == key.instanceId && args == key.args
+                && instanceKey == key.instanceKey;
+        }
+    };
+
+    using BlobRef = std::shared_ptr<const ValueBlob>;
+
+    // 已摘除、等待读者离开后回收的对象（blob 或被替换的桶数组）
+    using RetiredList = std::vector<std::shared_ptr<const void>>;
+
+    // 分片的无锁读索引：桶数固定为 2 的幂，重新配置容量时整体替换
+    struct Buckets {
+        explicit Buckets(size_t count)
+        : mask(count - 1),
+          heads(std::make_unique<std::atomic<const ValueBlob*>[]>(count)) {}
+
+        size_t                                           mask;
+        std::unique_ptr<std::atomic<const ValueBlob*>[]> heads;
+    };
+
+    struct Node;
+    using NodeList = std::list<Node*>;
+
+    struct Node {
+        const StoredKey*   key{}; // 指向所在哈希表节点的 key，地址稳定
+        BlobRef            blob;  // 当前发布的值
+        size_t             bytes{};
+        Region             region{Region::Window};
+        NodeList::iterator regionPos;
+        NodeList::iterator ownerPos;
+        NodeList::iterator instancePos;
+    };
+
+    // 同一 key 的一次在途求值；key 指向所在分片 flights 表中的 key，领头者结束时凭它摘除
+    struct Flight {
+        std::mutex              mutex;
+        std::condition_variable done;
+        const StoredKey*        key{};
+        std::thread::id         leader;
+        bool                    finished{};
+        bool                    succeeded{};
+        std::string             value;
+    };
+
+    using FlightTable = std::unordered_map<StoredKey, std::shared_ptr<Flight>, KeyHash, KeyEqual>;
+
+    struct Policy {
+        unsigned int                     ttlSeconds{};
+        uint32_t                         flags{};
+        std::shared_ptr<const Refresher> refresher;
+    };
+
+    enum class TimerKind : uint8_t { RefreshAhead, Expire };
+
+    // 定时器只记录 key 与写入序号，触发时重新查找并校验，条目被覆盖、淘汰或释放后自然失效
+    struct Timer {
+        StoredKey key;
+        uint64_t  serial{};
+        TimerKind kind{};
+    };
+
+    // Count-Min 频率估算：4 行 8 位计数器（上限 15）；累计记录数达到容量的 10 倍时全部减半，让旧热点逐渐冷却
+    class FrequencySketch {
+    public:
+        void     resize(size_t capacity);
+        void     increment(uint64_t hash);
+        unsigned estimate(uint64_t hash) const;
+
+    private:
+        static constexpr size_t kDepth = 4;
+
+        size_t indexOf(uint64_t hash, size_t row) const;
+
+        std::vector<uint8_t> mTable;
+        size_t               mWidthMask{};
+        size_t               mAdditions{};
+        size_t               mSampleSize{};
+    };
+
+    // 按线程条带划分的有损读缓冲：读者只写自己条带的槽位，写满一轮时尝试回放，拿不到锁则直接覆盖旧记录
+    static constexpr size_t kReadStripes = 16;
+    static constexpr size_t kReadSlots   = 16;
+
+    struct ReadSlot {
+        std::atomic<uint64_t> hash{};   // 0 表示空槽
+        std::atomic<uint64_t> serial{}; // 命中的 blob 序号；未命中为 0，只计入访问频率
+    };
+
+    struct alignas(64) ReadStripe {
+        std::array<ReadSlot, kReadSlots> slots;
+    };
+
+    // 计数器按线程分散到多条缓存行，避免所有读者争用同一计数
+    static constexpr size_t kCounterStripes = 16;
+
+    class StripedCounter {
+    public:
+        void     add(uint64_t n = 1) noexcept;
+        uint64_t load() const noexcept;
+
+    private:
+        struct alignas(64) Stripe {
+            std::atomic<uint64_t> value{};
+        };
+        std::array<Stripe, kCounterStripes> mStripes{};
+    };
+
+    struct Shard {
+        mutable std::mutex                                     mutex;
+        alignas(64) std::atomic<uint64_t>                      generation{}; // 每次写入或移除条目时递增，用于校验 L1
+        std::atomic<const Buckets*>                            buckets{};    // 读者看到的索引
+        std::shared_ptr<Buckets>                               table;        // buckets 的所有者
+        std::array<ReadStripe, kReadStripes>                   reads;
+        RetiredList                                            retired; // 等待批量交给 EpochDomain 的对象
+        std::unordered_map<uint64_t, Node*>                    serials; // blob 序号 -> 条目，用于回放读记录
+        std::unordered_map<StoredKey, Node, KeyHash, KeyEqual> index;
+        std::unordered_map<uint64_t, NodeList>                 owners;    // id -> 该占位符的条目，最近使用的在前
+        std::unordered_map<uint64_t, NodeList>                 instances; // 上下文实例 id（非 0）-> 该实例的条目
+        FlightTable                                            flights;   // 在途的单飞求值
+        NodeList                                               window;
+        NodeList                                               probation;
+        NodeList                                               protectedList;
+        FrequencySketch                                        sketch;
+        size_t                                                 bytes{};
+        size_t                                                 capacity{};
+        size_t                                                 windowCapacity{};
+        size_t                                                 protectedCapacity{};
+        size_t                                                 maxBytes{};
+        size_t                                                 quota{};
+    };
+
+    static constexpr unsigned kShardBits  = 4;
+    static constexpr size_t   kShardCount = size_t{1} << kShardBits;
+
+    // 线程本地 L1 的槽位，定义见实现文件
+    struct LocalSlot;
+    static LocalSlot& localSlot(uint64_t hash);
+
+    // 取哈希高位选分片，低位留给分片内的哈希表与频率估算
+    Shard& shardFor(uint64_t hash) { return mShards[hash >> (64 - kShardBits)]; }
+
+    static LookupKey lookupOf(const StoredKey& key) {
+        return {key.id, key.instanceId, key.hash, key.args, key.instanceKey};
+    }
+    static LookupKey lookupOf(uint64_t id, const PlaceholderCacheKey& key) {
+        return {id, key.instanceId, PlaceholderCacheKey::combine(id, key.hash), key.args, key.instanceKey};
+    }
+
+    void      write(const LookupKey& key, const std::string& value);
+    NodeList& listFor(Shard& shard, Region region);
+    void      touch(Shard& shard, Node& node);
+    void      insert(Shard& shard, const LookupKey& key, const std::string& value, const Policy& policy);
+    void      assign(Shard& shard, Node& node, const std::string& value, const Policy& policy);
+    void      admitFromWindow(Shard& shard);
+    void      enforceLimits(Shard& shard, const Node* keep);
+    void      erase(Shard& shard, Node& node);
+    Node*     mainVictim(Shard& shard, const Node* exclude);
+
+    // 无锁读索引：find 可在任意线程的 EpochDomain 临界区内调用，其余由持有分片锁的写者调用
+    static const ValueBlob* findBlob(const Shard& shard, const LookupKey& key);
+    void                    publish(Shard& shard, Node& node, BlobRef blob);
+    void                    unpublish(Shard& shard, Node& node);
+    void                    resizeBuckets(Shard& shard, size_t count);
+
+    // 读缓冲：record 由读者无锁调用，drain 在持有分片锁时回放
+    void recordRead(Shard& shard, uint64_t hash, uint64_t serial);
+    void drainReads(Shard& shard);
+    void drainStripe(Shard& shard, ReadStripe& stripe);
+
+    // 取出攒够一批的已摘除对象（force 时全部取出），由调用方在释放所有锁后交给 EpochDomain：
+    // 回收时可能析构任意对象，不能在持锁时进行
+    static RetiredList takeRetired(Shard& shard, bool force);
+    static void        retire(RetiredList retired);
+
+    // 时间轮由读写操作顺带推进（每个 tick 至多一次、拿不到锁即跳过），无需专门的线程
+    void advanceTimers(std::chrono::steady_clock::time_point now);
+    void fireTimer(const Timer& timer);
+    void submitRefresh(StoredKey key);
+    void cancelRefresh(const StoredKey& key);
+
+    mutable std::shared_mutex            mIdsMutex; // put 持读锁写入，release 持写锁注销，保证注销后不会再写入
+    std::unordered_map<uint64_t, Policy> mPolicies; // 存活的 id -> 缓存策略
+    std::atomic<uint64_t>                mNextId{1};
+    std::atomic<uint64_t>                mNextSerial{1};
+
+    std::mutex            mTimersMutex;
+    TimingWheel<Timer>    mTimers;
+    std::atomic<uint64_t> mEpoch;        // 全局唯一，重新配置时更换，使所有线程的 L1 失效
+    std::atomic<int64_t>  mNextTickAt{}; // mTimers.nextTickAt() 的计数，用于无锁判断是否需要推进
+    std::mutex            mExecutorMutex;
+    CacheExecutor         mExecutor;
+    std::atomic<bool>     mHasExecutor{};
+
+    std::array<Shard, kShardCount> mShards;
+
+    std::atomic<size_t>   mMaxEntries{};
+    std::atomic<size_t>   mMaxBytes{};
+    StripedCounter        mHits;
+    StripedCounter        mLocalHits;
+    StripedCounter        mMisses;
+    StripedCounter        mStaleHits;
+    std::atomic<uint64_t> mEvictions{};
+    std::atomic<uint64_t> mRejections{};
+    std::atomic<uint64_t> mQuotaEvictions{};
+    std::atomic<uint64_t> mInvalidations{};
+    std::atomic<uint64_t> mExpirations{};
+    std::atomic<uint64_t> mRefreshes{};
+    std::atomic<int64_t>  mFlightWaitMs{};
+    std::atomic<uint64_t> mFlightWaits{};
+    std::atomic<uint64_t> mCoalesced{};
+    std::atomic<uint64_t> mFlightFallbacks{};
+};
+
+} // namespace PA
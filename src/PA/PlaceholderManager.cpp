@@ -1,7 +1,14 @@
 // PlaceholderManager.cpp
+#include "PA/CompiledTemplate.h"
+#include "PA/Config/ConfigManager.h"
+#include "PA/FormatCache.h"
+#include "PA/MathExpression.h"
 #include "PA/PlaceholderAPI.h"
 #include "PA/PlaceholderProcessor.h"
 #include "PA/PlaceholderRegistry.h"
+#include "PA/TemplateCache.h"
+#include "PA/TickMemo.h"
+#include "PA/logger.h"
 
 
 #include <memory>
@@ -10,6 +17,22 @@ namespace PA {
 
 class PlaceholderManager final : public IPlaceholderService {
 public:
+    PlaceholderManager() : mTemplateCache(toCapacity(ConfigManager::getInstance().get().globalCacheSize)) {
+        configureValueCache(ConfigManager::getInstance().get());
+        FormatCache::global().setCapacity(toCapacity(ConfigManager::getInstance().get().formatCacheSize));
+        MathExpressionCache::global().setCapacity(
+            toCapacity(ConfigManager::getInstance().get().mathExpressionCacheSize)
+        );
+        configureRegexEngine(ConfigManager::getInstance().get());
+        ConfigManager::getInstance().onReload([this](const Config& config) {
+            mTemplateCache.setCapacity(toCapacity(config.globalCacheSize));
+            configureValueCache(config);
+            FormatCache::global().setCapacity(toCapacity(config.formatCacheSize));
+            MathExpressionCache::global().setCapacity(toCapacity(config.mathExpressionCacheSize));
+            configureRegexEngine(config);
+        });
+    }
+
     void registerPlaceholder(std::string_view prefix, std::shared_ptr<const IPlaceholder> p, void* owner) override {
         mRegistry.registerPlaceholder(prefix, p, owner);
     }
@@ -58,10 +81,16 @@ class PlaceholderManager final : public IPlaceholderService {
     }
 
     std::string replace(std::string_view text, const IContext* ctx) const override {
+        if (auto tpl = mTemplateCache.acquire(text, mRegistry.getVersion())) {
+            return PlaceholderProcessor::render(*tpl, ctx, mRegistry);
+        }
         return PlaceholderProcessor::process(text, ctx, mRegistry);
     }
 
     std::string replaceServer(std::string_view text) const override {
+        if (auto tpl = mTemplateCache.acquire(text, mRegistry.getVersion())) {
+            return PlaceholderProcessor::render(*tpl, nullptr, mRegistry);
+        }
         return PlaceholderProcessor::processServer(text, mRegistry);
     }
 
@@ -79,8 +108,72 @@ class PlaceholderManager final : public IPlaceholderService {
         mRegistry.registerContextFactory(contextTypeId, factory, owner);
     }
 
+    CompiledTemplateHandle compile(std::string_view text) const override {
+        return PlaceholderProcessor::compile(text);
+    }
+
+    std::string render(const CompiledTemplateHandle& tpl, const IContext* ctx) const override {
+        if (!tpl) {
+            return {};
+        }
+        return PlaceholderProcessor::render(*tpl, ctx, mRegistry);
+    }
+
+    TemplateCacheStats getTemplateCacheStats() const override { return mTemplateCache.stats(); }
+
+    ValueCacheStats getValueCacheStats() const override { return mRegistry.getCacheStore().stats(); }
+
+    void invalidateInstance(uint64_t instanceId) override {
+        if (instanceId == 0) {
+            return;
+        }
+        size_t removed = mRegistry.getCacheStore().invalidateInstance(instanceId);
+        logger.debug("Invalidated {} cached values of context instance {}", removed, instanceId);
+    }
+
+    void setCacheExecutor(CacheExecutor executor) override { mRegistry.getCacheStore().setExecutor(std::move(executor)); }
+
+    void beginBatch() override { mRegistry.beginBatch(); }
+
+    void commitBatch() override { mRegistry.commitBatch(); }
+
+    void beginEvaluationScope() override { TickMemo::enter(); }
+
+    void endEvaluationScope() override { TickMemo::exit(); }
+
 private:
-    PlaceholderRegistry mRegistry;
+    static size_t toCapacity(int configured) { return configured > 0 ? static_cast<size_t>(configured) : 0; }
+
+    void configureValueCache(const Config& config) {
+        mRegistry.getCacheStore().configure(
+            toCapacity(config.valueCacheMaxEntries),
+            toCapacity(config.valueCacheMaxMemoryMB) << 20,
+            static_cast<unsigned>(toCapacity(config.valueCachePlaceholderQuota)),
+            std::chrono::milliseconds(toCapacity(config.valueCacheSingleFlightWaitMs))
+        );
+    }
+
+    void configureRegexEngine(const Config& config) {
+        auto engine = ParameterParser::RegexEngine::Linear;
+        if (config.regexEngine == "std") {
+            engine = ParameterParser::RegexEngine::Std;
+        } else if (config.regexEngine != "linear") {
+            logger.warn("Unknown regexEngine '{}', falling back to 'linear'", config.regexEngine);
+        }
+        if (engine == mRegexEngine) {
+            return;
+        }
+        // 已缓存的格式化参数与模板绑定持有按旧引擎编译的正则，切换后丢弃以便重新解析；
+        // 用户持有的 CompiledTemplateHandle 不在模板缓存中，其绑定因 FormatCache 代数变化在下次 render 时重建
+        mRegexEngine = engine;
+        ParameterParser::setRegexEngine(engine);
+        FormatCache::global().clear();
+        mTemplateCache.clear();
+    }
+
+    PlaceholderRegistry          mRegistry;
+    mutable TemplateCache        mTemplateCache;
+    ParameterParser::RegexEngine mRegexEngine{ParameterParser::RegexEngine::Linear};
 };
 
 static PlaceholderManager gManager;
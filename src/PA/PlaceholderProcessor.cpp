@@ -1,10 +1,18 @@
 // src/PA/PlaceholderProcessor.cpp
 #include "PA/PlaceholderProcessor.h"
+#include "PA/CompiledTemplate.h"
+#include "PA/ContextInstance.h"
+#include "PA/DelimiterScanner.h"
+#include "PA/FormatCache.h"
 #include "PA/ParameterParser.h"
+#include "PA/PlaceholderCacheStore.h"
 #include "PA/PlaceholderRegistry.h"
+#include "PA/TickMemo.h"
 #include "PA/logger.h"
+#include <algorithm>
 #include <array>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 namespace PA {
@@ -31,23 +39,149 @@ bool isFormattingParameter(std::string_view param) {
     return false;
 }
 
-std::string buildCacheKey(const IContext* ctx, const std::string& cacheParamPart) {
-    std::string contextKey = ctx ? ctx->getContextInstanceKey() : "";
-    return contextKey + ":" + cacheParamPart;
+// 参数中可以嵌套带格式化参数的 {占位符}（如 {math:{a|precision=1}*2|precision=1}），只在花括号外的 '|' 处切分；
+// 与 splitParamString 一致，反斜杠转义的字符不参与配对
+size_t findTopLevelPipe(std::string_view param_part) {
+    int depth = 0;
+    for (size_t i = 0; i < param_part.size(); ++i) {
+        const char c = param_part[i];
+        if (c == '\\') {
+            ++i;
+        } else if (c == '{') {
+            ++depth;
+        } else if (c == '}' && depth > 0) {
+            --depth;
+        } else if (c == '|' && depth == 0) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// 只对缓存占位符使用实例标识：非内置上下文需要构造实例键字符串
+PlaceholderCacheKey makeCacheKey(const CachedEntry* entry, const ContextInstanceKey& instance, std::string_view args) {
+    if (!entry) {
+        return {0, {}};
+    }
+    return {instance.id(), args, instance.exactKey()};
+}
+
+// 缓存与 tick 备忘 key 取实例的上下文：服务器级缓存值不依赖上下文，不按实例拆分，后台刷新也只需刷新一份
+const IContext* instanceContext(const CachedEntry* entry, bool tickStable, const IContext* ctx) {
+    return tickStable || (entry && !entry->serverLevel) ? ctx : nullptr;
+}
+
+// 未命中后与其他线程的同 key 求值合并；返回 true 表示 out 已是在途求值的结果，否则由调用方求值
+bool joinInFlight(
+    const CachedEntry* entry, const PlaceholderCacheKey& key, PlaceholderCacheStore::FlightLease& lease, std::string& out
+) {
+    if (!entry || !entry->store->joinOrLead(entry->cacheId, key, out, lease)) {
+        return false;
+    }
+    logger.debug("3. Coalesced: reused in-flight evaluation, evaluatedValue='{}'", out);
+    return true;
+}
+
+bool isPlaceholderStart(char c) { return c == '{' || c == '%'; }
+
+// 求值一次占位符；类型化占位符的文本只生成一次，数值随之交给格式化阶段。
+// extended 为注册表检测到的 IExtendedPlaceholder 接口，为空时只走 evaluate()/evaluateWithArgs()
+void evaluatePlaceholder(
+    const IPlaceholder*                  placeholder,
+    const IExtendedPlaceholder*          extended,
+    const IContext*                      ctx,
+    const std::vector<std::string_view>& args,
+    bool                                 passArgs,
+    std::string&                         out,
+    std::optional<double>&               number
+) {
+    PlaceholderValue typed;
+    if (extended && extended->evaluateTyped(ctx, args, typed)) {
+        out.clear();
+        typed.appendTo(out);
+        number = typed.number();
+        return;
+    }
+    number.reset();
+    if (passArgs) {
+        placeholder->evaluateWithArgs(ctx, args, out);
+    } else {
+        placeholder->evaluate(ctx, out);
+    }
+}
+
+// 求值实际使用的参数：上下文别名占位符收到完整的参数部分，其余只收到缓存参数
+std::string_view
+evaluationArgs(const IPlaceholder* placeholder, std::string_view paramPart, std::string_view cacheParamPart) {
+    return placeholder->isContextAliasPlaceholder() ? paramPart : cacheParamPart;
 }
 
+/**
+ * @brief 单次 process 调用内的求值备忘
+ * 以 {占位符, 求值参数} 为 key，同一渲染中重复出现的占位符只求值一次；格式化参数可能不同，仍逐处应用。
+ * 上下文在整次渲染中不变，因此 key 不含上下文。
+ */
+class RenderMemo {
+public:
+    const std::string* find(const IPlaceholder* placeholder, std::string_view args) const {
+        auto it = mValues.find(KeyView{placeholder, args});
+        return it == mValues.end() ? nullptr : &it->second;
+    }
+
+    void store(const IPlaceholder* placeholder, std::string_view args, const std::string& value) {
+        mValues.try_emplace(Key{placeholder, std::string(args)}, value);
+    }
+
+    void clear() { mValues.clear(); }
+
+private:
+    struct Key {
+        const IPlaceholder* placeholder{};
+        std::string         args;
+    };
+
+    struct KeyView {
+        const IPlaceholder* placeholder{};
+        std::string_view    args;
+    };
+
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(const Key& key) const noexcept { return hash(key.placeholder, key.args); }
+        size_t operator()(const KeyView& key) const noexcept { return hash(key.placeholder, key.args); }
+
+        static size_t hash(const IPlaceholder* placeholder, std::string_view args) noexcept {
+            const size_t pointerHash = std::hash<const void*>{}(placeholder) * 0x9e3779b97f4a7c15ull;
+            return std::hash<std::string_view>{}(args) ^ pointerHash;
+        }
+    };
+
+    struct KeyEqual {
+        using is_transparent = void;
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const noexcept {
+            return a.placeholder == b.placeholder && std::string_view(a.args) == std::string_view(b.args);
+        }
+    };
+
+    std::unordered_map<Key, std::string, KeyHash, KeyEqual> mValues;
+};
+
 } // namespace
 
 size_t PlaceholderProcessor::findMatchingDelimiter(
-    std::string_view text, size_t start_pos, char open_delim, char close_delim
+    std::string_view text, const StructuralIndex& index, size_t open_index, char open_delim, char close_delim
 ) {
-    int    nesting_level = 1;
-    size_t scan_pos      = start_pos + 1;
-
-    while (scan_pos < text.length()) {
-        char current_char = text[scan_pos];
-        if (current_char == '\\' && scan_pos + 1 < text.length()) {
-            ++scan_pos;
+    int nesting_level = 1;
+
+    for (size_t i = open_index + 1; i < index.size(); ++i) {
+        size_t scan_pos     = index[i];
+        char   current_char = text[scan_pos];
+        if (current_char == '\\') {
+            // 转义：跳过紧随其后的字符；只有它本身也是结构字符时才会出现在索引中
+            if (i + 1 < index.size() && index[i + 1] == scan_pos + 1) {
+                ++i;
+            }
         } else if (current_char == open_delim) {
             ++nesting_level;
         } else if (current_char == close_delim) {
@@ -56,24 +190,29 @@ size_t PlaceholderProcessor::findMatchingDelimiter(
                 return scan_pos;
             }
         }
-        ++scan_pos;
     }
 
     return std::string_view::npos;
 }
 
-std::optional<PlaceholderMatch> PlaceholderProcessor::findNextPlaceholder(std::string_view text, size_t start_pos) {
-    size_t placeholder_start = text.find_first_of("%{", start_pos);
-    if (placeholder_start == std::string_view::npos) {
+std::optional<PlaceholderMatch> PlaceholderProcessor::findNextPlaceholder(
+    std::string_view text, const StructuralIndex& index, size_t& cursor, size_t start_pos
+) {
+    while (cursor < index.size() && (index[cursor] < start_pos || !isPlaceholderStart(text[index[cursor]]))) {
+        ++cursor;
+    }
+    if (cursor >= index.size()) {
         return std::nullopt;
     }
 
+    size_t placeholder_start = index[cursor];
+
     PlaceholderMatch match;
     match.start_pos = placeholder_start;
 
     char   open_delim = text[placeholder_start];
     char   close_delim = (open_delim == '{') ? '}' : '%';
-    size_t end_pos = findMatchingDelimiter(text, placeholder_start, open_delim, close_delim);
+    size_t end_pos = findMatchingDelimiter(text, index, cursor, open_delim, close_delim);
     if (end_pos == std::string_view::npos) {
         return match;
     }
@@ -85,58 +224,36 @@ std::optional<PlaceholderMatch> PlaceholderProcessor::findNextPlaceholder(std::s
 }
 
 void PlaceholderProcessor::parsePlaceholderContent(
-    PlaceholderMatch& match, const IContext* ctx, const PlaceholderRegistry& registry
+    PlaceholderMatch&          match,
+    const IContext*            ctx,
+    const PlaceholderRegistry& registry,
+    const RegistryReadGuard&   guard
 ) {
-    match.token.clear();
-    match.param_part.clear();
-    match.placeholder.reset();
-    match.cached_entry  = nullptr;
-    match.snapshot_guard.reset();
-
-    std::string content(match.content);
-    size_t      pipe_pos_in_content = content.find('|');
-    std::string token_search_part =
-        (pipe_pos_in_content != std::string::npos) ? content.substr(0, pipe_pos_in_content) : content;
-
-    for (size_t split_pos = token_search_part.length();;) {
-        std::string potential_token = token_search_part.substr(0, split_pos);
-        auto        find_result     = registry.findPlaceholder(potential_token, ctx);
-
-        if (find_result.placeholder) {
-            match.placeholder   = std::move(find_result.placeholder);
-            match.cached_entry  = find_result.entry;
-            match.snapshot_guard = std::move(find_result.snapshot_guard);
-            match.token         = potential_token;
-
-            if (split_pos < token_search_part.length()) {
-                if (token_search_part[split_pos] == ':') {
-                    match.param_part = token_search_part.substr(split_pos + 1);
-                    if (pipe_pos_in_content != std::string::npos) {
-                        match.param_part += "|" + content.substr(pipe_pos_in_content + 1);
-                    }
-                } else {
-                    match.placeholder.reset();
-                    match.cached_entry = nullptr;
-                    match.snapshot_guard.reset();
-                    match.token.clear();
-                }
-            } else if (pipe_pos_in_content != std::string::npos) {
-                match.param_part = "|" + content.substr(pipe_pos_in_content + 1);
-            }
-
-            if (match.placeholder) {
-                break;
-            }
-        }
-
-        if (split_pos == 0) {
-            break;
-        }
-        size_t prev_colon = token_search_part.rfind(':', split_pos - 1);
-        if (prev_colon == std::string::npos) {
-            break;
+    match.token        = {};
+    match.param_part   = {};
+    match.placeholder  = nullptr;
+    match.cached_entry = nullptr;
+    match.extended     = nullptr;
+
+    // token 与参数都是 content 的子串，全程以 string_view 引用，命中时不产生堆分配
+    std::string_view content             = match.content;
+    size_t           pipe_pos_in_content = content.find('|');
+    std::string_view token_search_part   = content.substr(0, pipe_pos_in_content);
+
+    size_t token_length = 0;
+    auto   find_result  = registry.findLongestPlaceholder(guard, token_search_part, ctx, token_length);
+    if (find_result.placeholder) {
+        match.placeholder  = find_result.placeholder;
+        match.cached_entry = find_result.entry;
+        match.extended     = find_result.extended;
+        match.token        = token_search_part.substr(0, token_length);
+
+        if (token_length < token_search_part.length()) {
+            // 形如 token:args|fmt，参数部分即 ':' 之后的全部内容
+            match.param_part = content.substr(token_length + 1);
+        } else if (pipe_pos_in_content != std::string_view::npos) {
+            match.param_part = content.substr(pipe_pos_in_content);
         }
-        split_pos = prev_colon;
     }
 
     logger.debug(
@@ -153,7 +270,7 @@ SeparatedParams PlaceholderProcessor::separateParameters(std::string_view param_
         return separated;
     }
 
-    size_t pipe_pos = param_part.find('|');
+    size_t pipe_pos = findTopLevelPipe(param_part);
     if (pipe_pos != std::string_view::npos) {
         separated.cache_param_part      = std::string(param_part.substr(0, pipe_pos));
         separated.formatting_param_part = std::string(param_part.substr(pipe_pos + 1));
@@ -183,57 +300,37 @@ SeparatedParams PlaceholderProcessor::separateParameters(std::string_view param_
 }
 
 bool PlaceholderProcessor::tryGetCachedValue(
-    const CachedEntry* entry, const IContext* ctx, const std::string& cache_param_part, std::string& out
+    const CachedEntry* entry, const PlaceholderCacheKey& key, std::string& out
 ) {
     if (!entry) {
         return false;
     }
 
-    std::string contextKey = ctx ? ctx->getContextInstanceKey() : "";
-    std::string cacheKey   = buildCacheKey(ctx, cache_param_part);
-
     logger.debug(
-        "Cache Check: contextKey='{}', cache_param_part='{}', fullCacheKey='{}', cacheDuration={}",
-        contextKey,
-        cache_param_part,
-        cacheKey,
+        "Cache Check: instanceId={}, cache_param_part='{}', cacheDuration={}",
+        key.instanceId,
+        key.args,
         entry->cacheDuration
     );
 
-    std::lock_guard<std::mutex> lock(entry->cacheMutex);
-    auto                        it = entry->cachedValues.find(cacheKey);
-    if (it == entry->cachedValues.end()) {
-        logger.debug("Cache Miss: No entry found for cacheKey='{}'", cacheKey);
+    if (!entry->store->get(entry->cacheId, key, out)) {
+        logger.debug("Cache Miss: no fresh entry for instanceId={}", key.instanceId);
         return false;
     }
-
-    auto now = std::chrono::steady_clock::now();
-    auto elapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(now - it->second.lastEvaluated).count();
-    logger.debug(
-        "Cache Entry Found: lastEvaluated={}, now={}, elapsedSeconds={}, cacheDuration={}",
-        std::chrono::duration_cast<std::chrono::seconds>(it->second.lastEvaluated.time_since_epoch()).count(),
-        std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count(),
-        elapsedSeconds,
-        entry->cacheDuration
-    );
-
-    if (elapsedSeconds >= entry->cacheDuration) {
-        logger.debug("Cache Expired: elapsedSeconds={} >= cacheDuration={}", elapsedSeconds, entry->cacheDuration);
-        return false;
-    }
-
-    out = it->second.value;
     logger.debug("3. Cache Hit: evaluatedValue='{}'", out);
     return true;
 }
 
 void PlaceholderProcessor::evaluateWithContext(
-    const IPlaceholder* placeholder,
-    const IContext*     ctx,
-    std::string_view    raw_param_part,
-    const std::string&  cache_param_part,
-    std::string&        out
+    const IPlaceholder*         placeholder,
+    const IExtendedPlaceholder* extended,
+    const IContext*             ctx,
+    std::string_view            raw_param_part,
+    const std::string&          cache_param_part,
+    std::string&                out,
+    std::optional<double>&      number
 ) {
+    number.reset();
     if (!placeholder) {
         return;
     }
@@ -243,12 +340,12 @@ void PlaceholderProcessor::evaluateWithContext(
         if (!raw_param_part.empty()) {
             args.push_back(raw_param_part);
         }
-        placeholder->evaluateWithArgs(ctx, args, out);
+        evaluatePlaceholder(placeholder, extended, ctx, args, true, out, number);
         return;
     }
 
     if (cache_param_part.empty()) {
-        placeholder->evaluate(ctx, out);
+        evaluatePlaceholder(placeholder, extended, ctx, {}, false, out, number);
         return;
     }
 
@@ -258,32 +355,64 @@ void PlaceholderProcessor::evaluateWithContext(
     for (const auto& arg : placeholder_args) {
         args.push_back(arg);
     }
-    placeholder->evaluateWithArgs(ctx, args, out);
+    evaluatePlaceholder(placeholder, extended, ctx, args, true, out, number);
 }
 
 void PlaceholderProcessor::updateCache(
-    const CachedEntry* entry, const IContext* ctx, const std::string& cache_param_part, const std::string& value
+    const CachedEntry* entry, const PlaceholderCacheKey& key, const std::string& value
 ) {
     if (!entry) {
         return;
     }
 
-    std::string cacheKey = buildCacheKey(ctx, cache_param_part);
-
-    std::lock_guard<std::mutex> lock(entry->cacheMutex);
-    entry->cachedValues[cacheKey] = {value, std::chrono::steady_clock::now()};
-    logger.debug("3.5. Cache Updated: cacheKey='{}', evaluatedValue='{}'", cacheKey, value);
+    entry->store->put(entry->cacheId, key, value);
+    logger.debug("3.5. Cache Updated: instanceId={}, evaluatedValue='{}'", key.instanceId, value);
 }
 
-void PlaceholderProcessor::applyFormatting(std::string& value, const std::string& formatting_param_part) {
+void PlaceholderProcessor::applyFormatting(
+    std::string&          value,
+    const std::string&    formatting_param_part,
+    std::optional<double> number
+) {
     if (formatting_param_part.empty()) {
         return;
     }
 
-    auto params = ParameterParser::parse(formatting_param_part);
-    ParameterParser::applyConditionalOutput(value, params.conditional);
+    applyFormatting(value, *FormatCache::global().acquire(formatting_param_part), number);
+}
+
+void PlaceholderProcessor::applyFormatting(
+    std::string&                              value,
+    const ParameterParser::PlaceholderParams& params,
+    std::optional<double>                     number
+) {
+    // number 始终与 value 对应：需要数值的阶段只在 number 为空时从文本解析一次，改写文本的阶段使其失效
+    bool numberKnown = number.has_value();
+    auto numeric     = [&]() -> std::optional<double> {
+        if (!numberKnown) {
+            number      = ParameterParser::parseNumber(value);
+            numberKnown = true;
+        }
+        return number;
+    };
+    auto invalidate = [&]() {
+        number.reset();
+        numberKnown = false;
+    };
+
+    if (params.conditional.enabled) {
+        if (auto n = numeric(); n && ParameterParser::applyConditionalOutput(value, params.conditional, *n)) {
+            invalidate();
+        }
+    }
     logger.debug("4. After applyConditionalOutput: evaluatedValue='{}'", value);
-    ParameterParser::formatNumericValue(value, params.precision);
+    if (params.precision != -1) {
+        // 颜色阈值与舍入后的文本比较（与逐阶段解析文本时一致），仅在需要时重新解析
+        if (auto n = numeric()) {
+            ParameterParser::formatNumericValue(value, *n, params.precision);
+            invalidate();
+        }
+    }
     logger.debug("5. After formatNumericValue: evaluatedValue='{}'", value);
     ParameterParser::applyBooleanMap(value, params.booleanMap);
     logger.debug("5.5. After applyBooleanMap: evaluatedValue='{}'", value);
@@ -293,27 +422,38 @@ void PlaceholderProcessor::applyFormatting(std::string& value, const std::string
     logger.debug("5.7. After applyRegexReplaceMap: evaluatedValue='{}'", value);
     ParameterParser::applyJsonMap(value, params.jsonMap);
     logger.debug("5.8. After applyJsonMap: evaluatedValue='{}'", value);
-
-    std::string_view colorFormat = "{color}{value}";
-    auto             colorFormatIt = params.otherParams.find("color_format");
-    if (colorFormatIt != params.otherParams.end()) {
-        colorFormat = colorFormatIt->second;
+    if (params.booleanMap.enabled || params.charReplaceMap.enabled || params.regexReplaceMap.enabled
+        || params.jsonMap.enabled) {
+        invalidate();
     }
 
     if (!params.conditional.enabled) {
-        ParameterParser::applyColorRules(value, params.colorParamPart, colorFormat);
+        const bool needsNumber = params.colorRules.mode == ParameterParser::ColorRules::Mode::Threshold;
+        ParameterParser::applyColorRules(value, params.colorRules, needsNumber ? numeric() : std::nullopt);
     }
     logger.debug("6. After applyColorRules: evaluatedValue='{}'", value);
 }
 
 std::string
 PlaceholderProcessor::process(std::string_view text, const IContext* ctx, const PlaceholderRegistry& registry) {
+    StructuralIndex index;
+    index.build(text);
+    if (!index.hasPlaceholderStart()) {
+        return std::string(text);
+    }
+
     std::string result;
     result.reserve(text.length());
-    size_t pos = 0;
+    size_t     pos    = 0;
+    size_t     cursor = 0;
+    RenderMemo memo;
+
+    // 借用指针所在的快照：首次命中时固定一次，之后的求值都在读临界区之外进行
+    std::shared_ptr<const void> pinned;
+    uint64_t                    pinnedVersion = 0;
 
     while (pos < text.length()) {
-        auto match = findNextPlaceholder(text, pos);
+        auto match = findNextPlaceholder(text, index, cursor, pos);
         if (!match) {
             result.append(text.substr(pos));
             break;
@@ -327,7 +467,19 @@ PlaceholderProcessor::process(std::string_view text, const IContext* ctx, const
             continue;
         }
 
-        parsePlaceholderContent(*match, ctx, registry);
+        {
+            // 只在查找期间停留在读临界区：求值可能发起 RemoteCall 或等待单飞结果，不应推迟旧快照的回收
+            RegistryReadGuard guard(registry);
+            parsePlaceholderContent(*match, ctx, registry, guard);
+            if (match->placeholder && (!pinned || guard.version() != pinnedVersion)) {
+                // 渲染途中发布了新快照：旧快照的占位符可能随之释放，以其地址为 key 的备忘不再可信
+                if (pinned) {
+                    memo.clear();
+                }
+                pinned        = guard.retain();
+                pinnedVersion = guard.version();
+            }
+        }
         if (!match->placeholder) {
             result.append(match->full_text);
             pos = match->end_pos + 1;
@@ -341,22 +493,51 @@ PlaceholderProcessor::process(std::string_view text, const IContext* ctx, const
             separated.formatting_param_part
         );
 
-        std::string evaluatedValue;
-        bool        useCachedValue = tryGetCachedValue(match->cached_entry, ctx, separated.cache_param_part, evaluatedValue);
-        if (!useCachedValue) {
-            logger.debug("Cache Miss or Expired: Re-evaluating placeholder.");
-            evaluateWithContext(
-                match->placeholder.get(),
-                ctx,
-                match->param_part,
-                separated.cache_param_part,
-                evaluatedValue
-            );
-            logger.debug("3. After Evaluate: evaluatedValue='{}'", evaluatedValue);
-            updateCache(match->cached_entry, ctx, separated.cache_param_part, evaluatedValue);
+        std::string      evaluatedValue;
+        std::string_view memoArgs = evaluationArgs(match->placeholder, match->param_part, separated.cache_param_part);
+
+        std::optional<double> number; // 仅在本处刚求值且占位符提供类型化结果时有值
+        if (const std::string* memoized = memo.find(match->placeholder, memoArgs)) {
+            evaluatedValue = *memoized;
+            logger.debug("3. Memoized: reused earlier occurrence, evaluatedValue='{}'", evaluatedValue);
+        } else {
+            // 只有未缓存的 tick 稳定占位符走作用域备忘；作用域外不调用 isTickStable()，也不取实例 id
+            const bool tickStable =
+                !match->cached_entry && TickMemo::active() && match->extended && match->extended->isTickStable();
+            const CachedEntry*       entry = match->cached_entry;
+            const ContextInstanceKey instance(instanceContext(entry, tickStable, ctx));
+            const std::string* stable = tickStable ? TickMemo::find(match->placeholder, instance, memoArgs) : nullptr;
+            if (stable) {
+                evaluatedValue = *stable;
+                logger.debug("3. Tick Memo Hit: evaluatedValue='{}'", evaluatedValue);
+            } else {
+                PlaceholderCacheKey cacheKey       = makeCacheKey(entry, instance, separated.cache_param_part);
+                bool                useCachedValue = tryGetCachedValue(entry, cacheKey, evaluatedValue);
+
+                PlaceholderCacheStore::FlightLease flight;
+                if (!useCachedValue && !joinInFlight(entry, cacheKey, flight, evaluatedValue)) {
+                    logger.debug("Cache Miss or Expired: Re-evaluating placeholder.");
+                    evaluateWithContext(
+                        match->placeholder,
+                        match->extended,
+                        ctx,
+                        match->param_part,
+                        separated.cache_param_part,
+                        evaluatedValue,
+                        number
+                    );
+                    logger.debug("3. After Evaluate: evaluatedValue='{}'", evaluatedValue);
+                    updateCache(entry, cacheKey, evaluatedValue);
+                    flight.complete(evaluatedValue);
+                }
+                if (tickStable) {
+                    TickMemo::store(match->placeholder, instance, memoArgs, evaluatedValue);
+                }
+            }
+            memo.store(match->placeholder, memoArgs, evaluatedValue);
         }
 
-        applyFormatting(evaluatedValue, separated.formatting_param_part);
+        applyFormatting(evaluatedValue, separated.formatting_param_part, number);
         logger.debug("7. Final Value: evaluatedValue='{}'", evaluatedValue);
         result.append(evaluatedValue);
         pos = match->end_pos + 1;
@@ -369,4 +550,233 @@ std::string PlaceholderProcessor::processServer(std::string_view text, const Pla
     return process(text, nullptr, registry);
 }
 
+std::shared_ptr<const CompiledTemplate> PlaceholderProcessor::compile(std::string_view text) {
+    auto tpl    = std::make_shared<CompiledTemplate>();
+    tpl->source = std::string(text);
+
+    std::string_view source  = tpl->source;
+    size_t           pos     = 0;
+    size_t           cursor  = 0;
+    size_t           literal = 0; // 当前字面量片段起点
+
+    StructuralIndex index;
+    index.build(source);
+
+    auto flushLiteral = [&](size_t end) {
+        if (end > literal) {
+            tpl->segments.push_back({literal, end - literal, 0, 0, false});
+        }
+    };
+
+    while (pos < source.length()) {
+        auto match = findNextPlaceholder(source, index, cursor, pos);
+        if (!match) {
+            break;
+        }
+        if (!match->isValid()) {
+            // 未闭合的定界符按普通字符处理，与 process 保持一致
+            pos = match->start_pos + 1;
+            continue;
+        }
+
+        flushLiteral(match->start_pos);
+        tpl->segments.push_back(
+            {match->start_pos,
+             match->full_text.length(),
+             match->start_pos + 1,
+             match->content.length(),
+             true}
+        );
+        ++tpl->placeholderCount;
+        pos     = match->end_pos + 1;
+        literal = pos;
+    }
+    flushLiteral(source.length());
+
+    return tpl;
+}
+
+std::shared_ptr<const TemplateBinding> PlaceholderProcessor::acquireBinding(
+    const CompiledTemplate& tpl, const IContext* ctx, const PlaceholderRegistry& registry
+) {
+    RegistryReadGuard guard(registry);
+    const uint64_t    contextTypeId = ctx ? ctx->typeId() : kServerContextId;
+    const uint64_t    version       = guard.version();
+    // 在解析格式化参数之前读取代数：绑定期间若切换了正则引擎，代数不一致，下次渲染会重新绑定
+    const uint64_t formatGeneration = FormatCache::global().generation();
+
+    {
+        std::lock_guard<std::mutex> lock(tpl.bindingMutex);
+        for (const auto& binding : tpl.bindings) {
+            if (binding->contextTypeId == contextTypeId && binding->registryVersion == version
+                && binding->formatGeneration == formatGeneration) {
+                return binding;
+            }
+        }
+    }
+
+    // 在锁外完成解析；整个绑定只借用 guard 锁定的同一份快照，并由 snapshotGuard 延长其生命周期
+    auto binding             = std::make_shared<TemplateBinding>();
+    binding->contextTypeId   = contextTypeId;
+    binding->registryVersion  = version;
+    binding->formatGeneration = formatGeneration;
+    binding->snapshotGuard   = guard.retain();
+    binding->nodes.reserve(tpl.placeholderCount);
+
+    for (const auto& segment : tpl.segments) {
+        if (!segment.isPlaceholder) {
+            continue;
+        }
+
+        PlaceholderMatch match;
+        match.start_pos = segment.offset;
+        match.end_pos   = segment.offset + segment.length - 1;
+        match.full_text = tpl.text(segment.offset, segment.length);
+        match.content   = tpl.text(segment.contentOffset, segment.contentLength);
+        parsePlaceholderContent(match, ctx, registry, guard);
+
+        // 原地构造，保证 args 中的 string_view 始终指向稳定的 argStorage
+        auto& node = binding->nodes.emplace_back();
+        if (!match.placeholder) {
+            continue;
+        }
+
+        node.placeholder = match.placeholder;
+        node.extended    = match.extended;
+        node.cachedEntry = match.cached_entry;
+        node.tickStable  = !node.cachedEntry && node.extended && node.extended->isTickStable();
+        node.paramPart   = std::string(match.param_part);
+        node.separated   = separateParameters(node.paramPart);
+
+        if (node.placeholder->isContextAliasPlaceholder()) {
+            if (!node.paramPart.empty()) {
+                node.argStorage.push_back(node.paramPart);
+            }
+            node.passArgs = true;
+        } else if (!node.separated.cache_param_part.empty()) {
+            node.argStorage = ParameterParser::splitParamString(node.separated.cache_param_part, ',');
+            node.passArgs   = true;
+        }
+        node.args.reserve(node.argStorage.size());
+        for (const auto& arg : node.argStorage) {
+            node.args.push_back(arg);
+        }
+
+        if (!node.separated.formatting_param_part.empty()) {
+            node.formatting = FormatCache::global().acquire(node.separated.formatting_param_part);
+        }
+    }
+
+    // 重复出现的 {占位符, 求值参数} 在绑定时分到同一备忘槽位，渲染时无需再比较参数
+    for (size_t i = 0; i < binding->nodes.size(); ++i) {
+        auto& node = binding->nodes[i];
+        if (!node.placeholder || node.memoSlot != BoundPlaceholder::kNoMemoSlot) {
+            continue;
+        }
+        std::string_view args = evaluationArgs(node.placeholder, node.paramPart, node.separated.cache_param_part);
+        for (size_t j = i + 1; j < binding->nodes.size(); ++j) {
+            auto& other = binding->nodes[j];
+            if (other.placeholder != node.placeholder || other.memoSlot != BoundPlaceholder::kNoMemoSlot
+                || evaluationArgs(other.placeholder, other.paramPart, other.separated.cache_param_part) != args) {
+                continue;
+            }
+            if (node.memoSlot == BoundPlaceholder::kNoMemoSlot) {
+                node.memoSlot = binding->memoSlots++;
+            }
+            other.memoSlot = node.memoSlot;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(tpl.bindingMutex);
+    auto                        it = std::find_if(tpl.bindings.begin(), tpl.bindings.end(), [&](const auto& existing) {
+        return existing->contextTypeId == contextTypeId;
+    });
+    if (it == tpl.bindings.end()) {
+        tpl.bindings.push_back(binding);
+    } else if ((*it)->registryVersion <= version) {
+        *it = binding;
+    }
+    return binding;
+}
+
+std::string
+PlaceholderProcessor::render(const CompiledTemplate& tpl, const IContext* ctx, const PlaceholderRegistry& registry) {
+    std::string result;
+    result.reserve(tpl.source.length());
+
+    std::shared_ptr<const TemplateBinding> binding;
+    std::vector<std::optional<std::string>> memo;
+    if (tpl.placeholderCount > 0) {
+        binding = acquireBinding(tpl, ctx, registry);
+        memo.resize(binding->memoSlots);
+    }
+
+    size_t nodeIndex = 0;
+    for (const auto& segment : tpl.segments) {
+        if (!segment.isPlaceholder) {
+            result.append(tpl.text(segment.offset, segment.length));
+            continue;
+        }
+
+        const auto& node = binding->nodes[nodeIndex++];
+        if (!node.placeholder) {
+            result.append(tpl.text(segment.offset, segment.length));
+            continue;
+        }
+
+        std::optional<std::string>* memoized =
+            node.memoSlot != BoundPlaceholder::kNoMemoSlot ? &memo[node.memoSlot] : nullptr;
+
+        std::string           evaluatedValue;
+        std::optional<double> number;
+        if (memoized && *memoized) {
+            evaluatedValue = **memoized;
+        } else {
+            const bool               tickStable = node.tickStable && TickMemo::active();
+            const ContextInstanceKey instance(instanceContext(node.cachedEntry, tickStable, ctx));
+            const std::string_view   stableArgs =
+                tickStable ? evaluationArgs(node.placeholder, node.paramPart, node.separated.cache_param_part)
+                           : std::string_view();
+            const std::string* stable = tickStable ? TickMemo::find(node.placeholder, instance, stableArgs) : nullptr;
+
+            if (stable) {
+                evaluatedValue = *stable;
+            } else {
+                PlaceholderCacheKey cacheKey =
+                    makeCacheKey(node.cachedEntry, instance, node.separated.cache_param_part);
+
+                PlaceholderCacheStore::FlightLease flight;
+                if (!tryGetCachedValue(node.cachedEntry, cacheKey, evaluatedValue)
+                    && !joinInFlight(node.cachedEntry, cacheKey, flight, evaluatedValue)) {
+                    evaluatePlaceholder(
+                        node.placeholder,
+                        node.extended,
+                        ctx,
+                        node.args,
+                        node.passArgs,
+                        evaluatedValue,
+                        number
+                    );
+                    logger.debug("3. After Evaluate: evaluatedValue='{}'", evaluatedValue);
+                    updateCache(node.cachedEntry, cacheKey, evaluatedValue);
+                    flight.complete(evaluatedValue);
+                }
+                if (tickStable) {
+                    TickMemo::store(node.placeholder, instance, stableArgs, evaluatedValue);
+                }
+            }
+            if (memoized) {
+                *memoized = evaluatedValue;
+            }
+        }
+
+        if (node.formatting) {
+            applyFormatting(evaluatedValue, *node.formatting, number);
+        }
+        result.append(evaluatedValue);
+    }
+
+    return result;
+}
+
 } // namespace PA
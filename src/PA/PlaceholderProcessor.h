@@ -2,6 +2,7 @@
 #pragma once
 
 #include "PA/PlaceholderAPI.h"
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -10,7 +11,16 @@ namespace PA {
 
 // 前向声明
 class PlaceholderRegistry;
+class RegistryReadGuard;
 struct CachedEntry;
+struct PlaceholderCacheKey;
+struct CompiledTemplate;
+struct TemplateBinding;
+class StructuralIndex;
+
+namespace ParameterParser {
+struct PlaceholderParams;
+}
 
 // ========== 辅助结构体 ==========
 
@@ -23,11 +33,11 @@ struct PlaceholderMatch {
     size_t           end_pos{};   // 结束位置
     std::string_view full_text;   // 完整文本 {xxx}
     std::string_view content;     // 内容部分 xxx
-    std::string      token;       // token部分
-    std::string      param_part;  // 参数部分
-    std::shared_ptr<const IPlaceholder> placeholder;
-    const CachedEntry*                  cached_entry = nullptr;
-    std::shared_ptr<const void>         snapshot_guard;
+    std::string_view token;       // token部分（指向 content）
+    std::string_view param_part;  // 参数部分（指向 content）
+    const IPlaceholder*         placeholder  = nullptr; // 借用自解析时的 RegistryReadGuard
+    const CachedEntry*          cached_entry = nullptr;
+    const IExtendedPlaceholder* extended     = nullptr; // placeholder 实现了 IExtendedPlaceholder 时指向它
 
     bool isValid() const noexcept { return end_pos > start_pos; }
 };
@@ -64,26 +74,53 @@ class PlaceholderProcessor {
      */
     static std::string processServer(std::string_view text, const PlaceholderRegistry& registry);
 
+    /**
+     * @brief 预编译模板：只扫描一次文本，记录字面量与占位符片段
+     * @param text 模板文本
+     * @return 不可变的预编译模板
+     */
+    static std::shared_ptr<const CompiledTemplate> compile(std::string_view text);
+
+    /**
+     * @brief 渲染预编译模板
+     * 首次以某上下文类型渲染，或注册表快照版本变化后，会重新解析 token 与参数；其余情况只做求值与格式化
+     * @param tpl 预编译模板
+     * @param ctx 上下文对象，nullptr 表示仅替换服务器级占位符
+     * @param registry 占位符注册表
+     * @return 替换后的文本
+     */
+    static std::string render(const CompiledTemplate& tpl, const IContext* ctx, const PlaceholderRegistry& registry);
+
 private:
     // ========== 查找相关 ==========
 
     /**
      * @brief 查找下一个占位符
      * @param text 文本内容
+     * @param index text 的结构字符索引
+     * @param cursor 索引游标（输入输出参数），随扫描单调前进；返回时指向占位符起始字符
      * @param start_pos 开始查找的位置
      * @return 占位符匹配结果，未找到则返回 nullopt
      */
-    static std::optional<PlaceholderMatch> findNextPlaceholder(std::string_view text, size_t start_pos);
+    static std::optional<PlaceholderMatch>
+    findNextPlaceholder(std::string_view text, const StructuralIndex& index, size_t& cursor, size_t start_pos);
 
     /**
-     * @brief 查找匹配的定界符（处理嵌套）
+     * @brief 查找匹配的定界符（处理嵌套与转义），只遍历结构字符索引
      * @param text 文本内容
-     * @param start_pos 起始位置
+     * @param index text 的结构字符索引
+     * @param open_index 起始定界符在索引中的下标
      * @param open_delim 开放定界符
      * @param close_delim 闭合定界符
      * @return 闭合定界符位置，未找到则返回 npos
      */
-    static size_t findMatchingDelimiter(std::string_view text, size_t start_pos, char open_delim, char close_delim);
+    static size_t findMatchingDelimiter(
+        std::string_view       text,
+        const StructuralIndex& index,
+        size_t                 open_index,
+        char                   open_delim,
+        char                   close_delim
+    );
 
     // ========== 解析相关 ==========
 
@@ -92,9 +129,14 @@ class PlaceholderProcessor {
      * @param match 占位符匹配结果（输入输出参数）
      * @param ctx 上下文对象
      * @param registry 占位符注册表
+     * @param guard 本次渲染持有的读保护，匹配结果中的指针借用自其锁定的快照
      */
-    static void
-    parsePlaceholderContent(PlaceholderMatch& match, const IContext* ctx, const PlaceholderRegistry& registry);
+    static void parsePlaceholderContent(
+        PlaceholderMatch&          match,
+        const IContext*            ctx,
+        const PlaceholderRegistry& registry,
+        const RegistryReadGuard&   guard
+    );
 
     /**
      * @brief 分离缓存参数和格式化参数
@@ -108,46 +150,39 @@ class PlaceholderProcessor {
     /**
      * @brief 尝试从缓存获取值
      * @param entry 缓存条目
-     * @param ctx 上下文对象
-     * @param cache_param_part 缓存参数
+     * @param key 上下文实例 id 与缓存参数组成的缓存 key
      * @param out 输出结果
      * @return 是否成功从缓存获取
      */
-    static bool tryGetCachedValue(
-        const CachedEntry* entry,
-        const IContext*    ctx,
-        const std::string& cache_param_part,
-        std::string&       out
-    );
+    static bool tryGetCachedValue(const CachedEntry* entry, const PlaceholderCacheKey& key, std::string& out);
 
     /**
      * @brief 执行占位符求值
      * @param placeholder 占位符对象
+     * @param extended placeholder 实现的 IExtendedPlaceholder 接口，为空时不做类型化求值
      * @param ctx 上下文对象
-     * @param cache_param_part 缓存参数
+     * @param raw_param_part 未分离的完整参数，上下文别名占位符将其整体作为唯一参数
+     * @param cache_param_part 缓存参数，其他占位符按逗号切分后作为参数
      * @param out 输出结果
+     * @param number 类型化占位符的数值形式，其他占位符置空
      */
     static void evaluateWithContext(
-        const IPlaceholder* placeholder,
-        const IContext*     ctx,
-        std::string_view    raw_param_part,
-        const std::string&  cache_param_part,
-        std::string&        out
+        const IPlaceholder*         placeholder,
+        const IExtendedPlaceholder* extended,
+        const IContext*             ctx,
+        std::string_view            raw_param_part,
+        const std::string&          cache_param_part,
+        std::string&                out,
+        std::optional<double>&      number
     );
 
     /**
      * @brief 更新缓存
      * @param entry 缓存条目
-     * @param ctx 上下文对象
-     * @param cache_param_part 缓存参数
+     * @param key 上下文实例 id 与缓存参数组成的缓存 key
      * @param value 要缓存的值
      */
-    static void updateCache(
-        const CachedEntry* entry,
-        const IContext*    ctx,
-        const std::string& cache_param_part,
-        const std::string& value
-    );
+    static void updateCache(const CachedEntry* entry, const PlaceholderCacheKey& key, const std::string& value);
 
     // ========== 格式化相关 ==========
 
@@ -155,8 +190,37 @@ class PlaceholderProcessor {
      * @brief 应用所有格式化规则
      * @param value 要格式化的值（输入输出参数）
      * @param formatting_param_part 格式化参数
+     * @param number value 对应的数值；为空时由需要数值的阶段从文本解析一次
+     */
+    static void applyFormatting(
+        std::string&          value,
+        const std::string&    formatting_param_part,
+        std::optional<double> number = std::nullopt
+    );
+
+    /**
+     * @brief 应用已解析的格式化参数
+     * @param value 要格式化的值（输入输出参数）
+     * @param params 已解析的格式化参数
+     * @param number value 对应的数值；为空时由需要数值的阶段从文本解析一次
+     */
+    static void applyFormatting(
+        std::string&                              value,
+        const ParameterParser::PlaceholderParams& params,
+        std::optional<double>                     number = std::nullopt
+    );
+
+    // ========== 预编译模板相关 ==========
+
+    /**
+     * @brief 获取模板在当前上下文类型与快照版本下的绑定，不存在或已过期时重新绑定
+     * @param tpl 预编译模板
+     * @param ctx 上下文对象
+     * @param registry 占位符注册表
+     * @return 绑定结果
      */
-    static void applyFormatting(std::string& value, const std::string& formatting_param_part);
+    static std::shared_ptr<const TemplateBinding>
+    acquireBinding(const CompiledTemplate& tpl, const IContext* ctx, const PlaceholderRegistry& registry);
 };
 
 } // namespace PA
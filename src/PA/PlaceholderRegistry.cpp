@@ -1,14 +1,345 @@
 // src/PA/PlaceholderRegistry.cpp
 #include "PA/PlaceholderRegistry.h"
 #include "PA/AdapterAliasPlaceholder.h"
+#include "PA/ParameterParser.h"
 #include "PA/logger.h"
 
 #include <algorithm>
 #include <cctype>
+#include <random>
 
 namespace PA {
 
-PlaceholderRegistry::PlaceholderRegistry() : mSnapshot(std::make_shared<const Snapshot>()) {}
+namespace {
+
+// key 第一个 ':' 之前部分的哈希，与 lookupLongest 扫描首段时累加的哈希一致
+uint64_t firstSegmentHash(std::string_view key) { return TokenHash{}(key.substr(0, key.find(':'))); }
+
+// 否定缓存指纹的起始值，每个进程随机：聊天文本无法预先构造出与已注册 token 指纹相同、从而屏蔽它的内容
+const uint64_t kMissFingerprintSeed = [] {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32 | device()) ^ TokenHash::kOffsetBasis;
+}();
+
+// 条目存在且属于 owner
+template <typename T>
+bool ownedBy(const T* entry, void* owner) {
+    return entry && entry->owner == owner;
+}
+
+template <typename T>
+bool ownedBy(const std::shared_ptr<T>* entry, void* owner) {
+    return entry && (*entry)->owner == owner;
+}
+
+// 从两层嵌套映射中删除 outer[id][key]，内层为空时一并删除
+template <typename Outer>
+void eraseNested(Outer& outer, uint64_t id, std::string_view key) {
+    auto& inner = outer[id];
+    inner.erase(key);
+    if (inner.empty()) outer.erase(id);
+}
+
+} // namespace
+
+PlaceholderRegistry::PlaceholderRegistry() : mCacheStore(std::make_shared<PlaceholderCacheStore>()) {
+    auto snapshot         = std::make_shared<Snapshot>();
+    snapshot->cacheStore  = mCacheStore;
+    snapshot->serverTable = buildResolutionTable(*snapshot, kServerContextId, {});
+    mSnapshot.store(snapshot.get(), std::memory_order_seq_cst);
+    mPublished = std::move(snapshot);
+}
+
+void PlaceholderRegistry::publish(std::shared_ptr<Snapshot> snapshot) {
+    auto base             = mPublished;
+    snapshot->version     = base->version + 1;
+    snapshot->serverTable = updateResolutionTable(*base->serverTable, *snapshot, kServerContextId, {}, mDirtyKeys);
+
+    std::unordered_map<uint64_t, std::vector<uint64_t>> chains;
+    {
+        std::lock_guard<std::mutex> lock(mChainsMutex);
+        chains = mContextChains;
+    }
+    if (!chains.empty()) {
+        const auto* baseTables = base->tables.load(std::memory_order_acquire);
+        auto        tables     = std::make_unique<ResolutionTableSet>();
+        for (const auto& [typeId, inheritedTypeIds] : chains) {
+            const ResolutionTable* previous = nullptr;
+            if (baseTables) {
+                auto it = baseTables->find(typeId);
+                if (it != baseTables->end()) previous = it->second.get();
+            }
+            tables->emplace(
+                typeId,
+                previous ? updateResolutionTable(*previous, *snapshot, typeId, inheritedTypeIds, mDirtyKeys)
+                         : buildResolutionTable(*snapshot, typeId, inheritedTypeIds)
+            );
+        }
+        snapshot->tables.store(tables.get(), std::memory_order_release);
+        snapshot->tableSets.push_back(std::move(tables));
+    }
+
+    mDirtyKeys.clear();
+    auto store = snapshot->cacheStore;
+    mSnapshot.store(snapshot.get(), std::memory_order_seq_cst);
+    mPublished = std::move(snapshot);
+
+    // 旧快照可能仍被读者借用，等它们离开当前 epoch 后再释放引用
+    EpochDomain::global().retire([previous = std::move(base)]() mutable { previous.reset(); });
+
+    // 新快照已不再引用这些条目；仍持有旧快照的渲染对它们的写入会被 store 忽略
+    for (uint64_t id : mRetiredCacheIds) {
+        store->release(id);
+    }
+    mRetiredCacheIds.clear();
+}
+
+uint64_t PlaceholderRegistry::getVersion() const {
+    RegistryReadGuard guard(*this);
+    return guard.version();
+}
+
+PlaceholderRegistry::Snapshot* PlaceholderRegistry::beginWrite() {
+    if (mBatchDepth > 0) {
+        mPendingDirty = true;
+    } else {
+        mPending = std::make_shared<Snapshot>(*mPublished);
+    }
+    return mPending.get();
+}
+
+void PlaceholderRegistry::endWrite() {
+    if (mBatchDepth == 0) {
+        publish(std::move(mPending));
+        mPending.reset();
+    }
+}
+
+void PlaceholderRegistry::beginBatch() {
+    mWriteMutex.lock();
+    if (mBatchDepth++ == 0) {
+        mPending      = std::make_shared<Snapshot>(*mPublished);
+        mPendingDirty = false;
+    }
+}
+
+void PlaceholderRegistry::commitBatch() {
+    if (--mBatchDepth == 0) {
+        if (mPendingDirty) {
+            publish(std::move(mPending));
+        }
+        mPending.reset();
+        mPendingDirty = false;
+        mDirtyKeys.clear();
+    }
+    mWriteMutex.unlock();
+}
+
+std::shared_ptr<CachedEntry> PlaceholderRegistry::makeCachedEntry(
+    std::shared_ptr<const IPlaceholder> p,
+    void*                               owner,
+    unsigned int                        cacheDuration,
+    bool                                serverLevel
+) {
+    PlaceholderCacheStore* store = mPending->cacheStore.get();
+
+    // 服务器级占位符不依赖渲染上下文，可在执行器上按缓存参数重新求值（与 PlaceholderProcessor 的参数拆分一致）；
+    // 其他占位符没有 refresher，store 只保留其单飞策略；未实现 IExtendedPlaceholder 的占位符没有任何策略
+    const auto*                      extended = dynamic_cast<const IExtendedPlaceholder*>(p.get());
+    const uint32_t                   flags    = extended ? extended->getCacheFlags() : 0;
+    PlaceholderCacheStore::Refresher refresher;
+    if (serverLevel && (flags & (kCacheRefreshAhead | kCacheStaleWhileRevalidate))) {
+        refresher = [placeholder = p](std::string_view cacheArgs, std::string& out) {
+            if (cacheArgs.empty()) {
+                placeholder->evaluate(nullptr, out);
+                return;
+            }
+            std::vector<std::string>      parts = ParameterParser::splitParamString(cacheArgs, ',');
+            std::vector<std::string_view> args(parts.begin(), parts.end());
+            placeholder->evaluateWithArgs(nullptr, args, out);
+        };
+    }
+
+    auto entry           = std::make_shared<CachedEntry>();
+    entry->ptr           = std::move(p);
+    entry->owner         = owner;
+    entry->cacheDuration = cacheDuration;
+    entry->cacheId       = store->allocate(cacheDuration, flags, std::move(refresher));
+    entry->store         = store;
+    entry->serverLevel   = serverLevel;
+    return entry;
+}
+
+void PlaceholderRegistry::addHandle(Snapshot& snapshot, void* owner, Handle handle) {
+    HandleList& list = snapshot.ownerIndex[owner];
+    list             = std::make_shared<const HandleNode>(HandleNode{std::move(handle), std::move(list)});
+}
+
+std::optional<PlaceholderRegistry::ResolvedEntry> PlaceholderRegistry::resolveKey(
+    const Snapshot&              snapshot,
+    std::string_view             key,
+    uint64_t                     contextTypeId,
+    const std::vector<uint64_t>& inheritedTypeIds
+) {
+    if (contextTypeId != kServerContextId) {
+        if (const auto* adapters = snapshot.adapters.find(key)) {
+            for (uint64_t id : inheritedTypeIds) {
+                auto it = std::find_if(adapters->begin(), adapters->end(), [id](const Adapter& ad) {
+                    return ad.fromCtxId == id;
+                });
+                if (it != adapters->end()) {
+                    return ResolvedEntry{it->placeholder, nullptr, ResolvedKind::Alias};
+                }
+            }
+        }
+
+        for (uint64_t id : inheritedTypeIds) {
+            const auto* inner = snapshot.cached_typed.find(id);
+            if (const auto* entry = inner ? inner->find(key) : nullptr) {
+                return ResolvedEntry{(*entry)->ptr, *entry, ResolvedKind::CachedTyped};
+            }
+        }
+        for (uint64_t id : inheritedTypeIds) {
+            const auto* inner = snapshot.typed.find(id);
+            if (const auto* entry = inner ? inner->find(key) : nullptr) {
+                return ResolvedEntry{entry->ptr, nullptr, ResolvedKind::Typed};
+            }
+        }
+
+        if (const auto* cachedMain = snapshot.cached_relational.find(contextTypeId)) {
+            for (uint64_t relId : inheritedTypeIds) {
+                const auto* inner = cachedMain->find(relId);
+                if (const auto* entry = inner ? inner->find(key) : nullptr) {
+                    return ResolvedEntry{(*entry)->ptr, *entry, ResolvedKind::CachedRelational};
+                }
+            }
+        }
+        if (const auto* main = snapshot.relational.find(contextTypeId)) {
+            for (uint64_t relId : inheritedTypeIds) {
+                const auto* inner = main->find(relId);
+                if (const auto* entry = inner ? inner->find(key) : nullptr) {
+                    return ResolvedEntry{entry->ptr, nullptr, ResolvedKind::Relational};
+                }
+            }
+        }
+    }
+
+    if (const auto* entry = snapshot.cached_server.find(key)) {
+        return ResolvedEntry{(*entry)->ptr, *entry, ResolvedKind::CachedServer};
+    }
+    if (const auto* entry = snapshot.server.find(key)) {
+        return ResolvedEntry{entry->ptr, nullptr, ResolvedKind::Server};
+    }
+    return std::nullopt;
+}
+
+std::shared_ptr<const PlaceholderRegistry::ResolutionTable> PlaceholderRegistry::buildResolutionTable(
+    const Snapshot&              snapshot,
+    uint64_t                     contextTypeId,
+    const std::vector<uint64_t>& inheritedTypeIds
+) {
+    auto table = std::make_shared<ResolutionTable>();
+
+    // 收集该类型可能看到的全部 key，逐个按优先级解析
+    auto add = [&](const std::string& key, const auto& /* value */) {
+        if (table->entries.contains(key)) return;
+        if (auto resolved = resolveKey(snapshot, key, contextTypeId, inheritedTypeIds)) {
+            table->assign(key, std::move(*resolved));
+        }
+    };
+    if (contextTypeId != kServerContextId) {
+        snapshot.adapters.forEach(add);
+        for (uint64_t id : inheritedTypeIds) {
+            if (const auto* inner = snapshot.cached_typed.find(id)) inner->forEach(add);
+            if (const auto* inner = snapshot.typed.find(id)) inner->forEach(add);
+        }
+        if (const auto* cachedMain = snapshot.cached_relational.find(contextTypeId)) {
+            cachedMain->forEach([&](uint64_t, const auto& inner) { inner.forEach(add); });
+        }
+        if (const auto* main = snapshot.relational.find(contextTypeId)) {
+            main->forEach([&](uint64_t, const auto& inner) { inner.forEach(add); });
+        }
+    }
+    snapshot.cached_server.forEach(add);
+    snapshot.server.forEach(add);
+    return table;
+}
+
+std::shared_ptr<const PlaceholderRegistry::ResolutionTable> PlaceholderRegistry::updateResolutionTable(
+    const ResolutionTable&          previous,
+    const Snapshot&                 snapshot,
+    uint64_t                        contextTypeId,
+    const std::vector<uint64_t>&    inheritedTypeIds,
+    const std::vector<std::string>& dirtyKeys
+) {
+    auto table = std::make_shared<ResolutionTable>(previous);
+    for (const std::string& key : dirtyKeys) {
+        if (auto resolved = resolveKey(snapshot, key, contextTypeId, inheritedTypeIds)) {
+            table->assign(key, std::move(*resolved));
+        } else {
+            table->entries.erase(key);
+        }
+    }
+    return table;
+}
+
+void PlaceholderRegistry::ResolutionTable::assign(const std::string& key, ResolvedEntry resolved) {
+    resolved.extended = dynamic_cast<const IExtendedPlaceholder*>(resolved.placeholder.get());
+    entries[key]      = std::move(resolved);
+    maxKeyLength = std::max(maxKeyLength, key.length());
+    maxSegments  = std::max(maxSegments, static_cast<size_t>(std::count(key.begin(), key.end(), ':')) + 1);
+    if (firstSegments.full()) {
+        rebuildFilter();
+    } else {
+        firstSegments.insert(firstSegmentHash(key));
+    }
+}
+
+// 按当前条目数的两倍重建，顺带清除已删除 key 留下的位；重建开销摊还到之后的插入上
+void PlaceholderRegistry::ResolutionTable::rebuildFilter() {
+    firstSegments.reset(entries.size() * 2);
+    entries.forEach([this](const std::string& key, const ResolvedEntry&) {
+        firstSegments.insert(firstSegmentHash(key));
+    });
+}
+
+const PlaceholderRegistry::ResolutionTable&
+PlaceholderRegistry::tableFor(const Snapshot& snapshot, const IContext* ctx) const {
+    if (!ctx) {
+        return *snapshot.serverTable;
+    }
+
+    const uint64_t typeId = ctx->typeId();
+    if (const auto* tables = snapshot.tables.load(std::memory_order_acquire)) {
+        auto it = tables->find(typeId);
+        if (it != tables->end()) {
+            return *it->second;
+        }
+    }
+
+    // 首次遇到该上下文类型：为当前快照补建解析表（版本号不变），并记住继承链供后续发布预建
+    std::lock_guard<std::mutex> lock(snapshot.tablesMutex);
+    const auto*                 current = snapshot.tables.load(std::memory_order_acquire);
+    if (current) {
+        auto it = current->find(typeId);
+        if (it != current->end()) {
+            return *it->second;
+        }
+    }
+
+    const auto& inheritedTypeIds = ctx->getInheritedTypeIds();
+    {
+        std::lock_guard<std::mutex> chainsLock(mChainsMutex);
+        mContextChains.try_emplace(typeId, inheritedTypeIds);
+    }
+
+    auto tables = current ? std::make_unique<ResolutionTableSet>(*current) : std::make_unique<ResolutionTableSet>();
+    auto table  = buildResolutionTable(snapshot, typeId, inheritedTypeIds);
+    tables->emplace(typeId, table);
+    snapshot.tables.store(tables.get(), std::memory_order_release);
+    snapshot.tableSets.push_back(std::move(tables)); // 旧表集合可能仍被并发读者使用，随快照一起释放
+    return *table;
+}
 
 std::string PlaceholderRegistry::toLowerKey(std::string_view s) {
     std::string result(s);
@@ -52,60 +383,64 @@ void PlaceholderRegistry::registerPlaceholder(
     unsigned int cacheDuration = p->getCacheDuration();
     std::string  key           = buildKey(prefix, p->token());
 
-    std::lock_guard<std::mutex> lk(mWriteMutex);
-    auto                        newSnapshot = std::make_shared<Snapshot>(*mSnapshot.load());
+    std::lock_guard<std::recursive_mutex> lk(mWriteMutex);
+    Snapshot*                             newSnapshot = beginWrite();
+    markDirty(key);
 
     const uint64_t ctxId = p->contextTypeId();
     if (cacheDuration > 0) {
-        CachedEntry entry;
-        entry.ptr           = p;
-        entry.owner         = owner;
-        entry.cacheDuration = cacheDuration;
+        auto entry = makeCachedEntry(p, owner, cacheDuration, ctxId == kServerContextId);
         if (ctxId == kServerContextId) {
+            retireCachedEntry(newSnapshot->cached_server.find(key));
             bool hadExisting = newSnapshot->cached_server.contains(key);
             hadExisting      = newSnapshot->server.erase(key) > 0 || hadExisting;
             if (hadExisting) {
                 logger.warn("[PA::Registry] Overwriting server placeholder '{}'", key);
             }
             newSnapshot->cached_server[key] = std::move(entry);
-            newSnapshot->ownerIndex[owner].push_back({true, false, true, false, false, 0, 0, 0, key});
+            addHandle(*newSnapshot, owner, {true, false, true, false, false, 0, 0, 0, key});
         } else {
-            auto& cachedMap   = newSnapshot->cached_typed[ctxId];
-            bool  hadExisting = cachedMap.contains(key);
-            hadExisting       = newSnapshot->typed[ctxId].erase(key) > 0 || hadExisting;
+            const auto* cachedMap   = newSnapshot->cached_typed.find(ctxId);
+            const auto* typedMap    = newSnapshot->typed.find(ctxId);
+            bool        hadExisting = (cachedMap && cachedMap->contains(key)) || (typedMap && typedMap->contains(key));
+            if (cachedMap) {
+                retireCachedEntry(cachedMap->find(key));
+            }
+            if (typedMap && typedMap->contains(key)) {
+                eraseNested(newSnapshot->typed, ctxId, key);
+            }
             if (hadExisting) {
                 logger.warn("[PA::Registry] Overwriting typed placeholder '{}' for ctxId={}", key, ctxId);
             }
-            cachedMap[key] = std::move(entry);
-            newSnapshot->ownerIndex[owner].push_back({false, false, true, false, false, 0, 0, ctxId, key});
+            newSnapshot->cached_typed[ctxId][key] = std::move(entry);
+            addHandle(*newSnapshot, owner, {false, false, true, false, false, 0, 0, ctxId, key});
         }
     } else {
         if (ctxId == kServerContextId) {
+            retireCachedEntry(newSnapshot->cached_server.find(key));
             bool hadExisting = newSnapshot->server.contains(key);
             hadExisting      = newSnapshot->cached_server.erase(key) > 0 || hadExisting;
             if (hadExisting) {
                 logger.warn("[PA::Registry] Overwriting server placeholder '{}'", key);
             }
             newSnapshot->server[key] = {p, owner};
-            newSnapshot->ownerIndex[owner].push_back({true, false, false, false, false, 0, 0, 0, key});
+            addHandle(*newSnapshot, owner, {true, false, false, false, false, 0, 0, 0, key});
         } else {
-            auto& typedMap    = newSnapshot->typed[ctxId];
-            bool  hadExisting = typedMap.contains(key);
-            auto  cachedIt    = newSnapshot->cached_typed.find(ctxId);
-            if (cachedIt != newSnapshot->cached_typed.end()) {
-                hadExisting = cachedIt->second.erase(key) > 0 || hadExisting;
-                if (cachedIt->second.empty()) {
-                    newSnapshot->cached_typed.erase(cachedIt);
-                }
+            const auto* cachedMap   = newSnapshot->cached_typed.find(ctxId);
+            const auto* typedMap    = newSnapshot->typed.find(ctxId);
+            bool        hadExisting = (cachedMap && cachedMap->contains(key)) || (typedMap && typedMap->contains(key));
+            if (cachedMap && cachedMap->contains(key)) {
+                retireCachedEntry(cachedMap->find(key));
+                eraseNested(newSnapshot->cached_typed, ctxId, key);
             }
             if (hadExisting) {
                 logger.warn("[PA::Registry] Overwriting typed placeholder '{}' for ctxId={}", key, ctxId);
             }
-            typedMap[key] = {p, owner};
-            newSnapshot->ownerIndex[owner].push_back({false, false, false, false, false, 0, 0, ctxId, key});
+            newSnapshot->typed[ctxId][key] = {p, owner};
+            addHandle(*newSnapshot, owner, {false, false, false, false, false, 0, 0, ctxId, key});
         }
     }
-    mSnapshot.store(newSnapshot);
+    endWrite();
 }
 
 void PlaceholderRegistry::registerCachedPlaceholder(
@@ -130,20 +465,22 @@ void PlaceholderRegistry::registerRelationalPlaceholder(
 
     std::string key = buildKey(prefix, p->token());
 
-    std::lock_guard<std::mutex> lk(mWriteMutex);
-    auto                        newSnapshot = std::make_shared<Snapshot>(*mSnapshot.load());
-
-    auto& relationalMap = newSnapshot->relational[mainContextTypeId][relationalContextTypeId];
-    bool  hadExisting   = relationalMap.contains(key);
-
-    auto cachedMainIt = newSnapshot->cached_relational.find(mainContextTypeId);
-    if (cachedMainIt != newSnapshot->cached_relational.end()) {
-        auto cachedRelIt = cachedMainIt->second.find(relationalContextTypeId);
-        if (cachedRelIt != cachedMainIt->second.end()) {
-            hadExisting = cachedRelIt->second.erase(key) > 0 || hadExisting;
-            if (cachedRelIt->second.empty()) cachedMainIt->second.erase(cachedRelIt);
-            if (cachedMainIt->second.empty()) newSnapshot->cached_relational.erase(cachedMainIt);
-        }
+    std::lock_guard<std::recursive_mutex> lk(mWriteMutex);
+    Snapshot*                             newSnapshot = beginWrite();
+    markDirty(key);
+
+    const auto* relationalMain = newSnapshot->relational.find(mainContextTypeId);
+    const auto* relationalMap  = relationalMain ? relationalMain->find(relationalContextTypeId) : nullptr;
+    bool        hadExisting    = relationalMap && relationalMap->contains(key);
+
+    const auto* cachedMain = newSnapshot->cached_relational.find(mainContextTypeId);
+    const auto* cachedRel  = cachedMain ? cachedMain->find(relationalContextTypeId) : nullptr;
+    if (cachedRel && cachedRel->contains(key)) {
+        retireCachedEntry(cachedRel->find(key));
+        hadExisting = true;
+        auto& main  = newSnapshot->cached_relational[mainContextTypeId];
+        eraseNested(main, relationalContextTypeId, key);
+        if (main.empty()) newSnapshot->cached_relational.erase(mainContextTypeId);
     }
 
     if (hadExisting) {
@@ -155,11 +492,9 @@ void PlaceholderRegistry::registerRelationalPlaceholder(
         );
     }
 
-    relationalMap[key] = {p, owner};
-    newSnapshot->ownerIndex[owner].push_back(
-        {false, true, false, false, false, mainContextTypeId, relationalContextTypeId, 0, key}
-    );
-    mSnapshot.store(newSnapshot);
+    newSnapshot->relational[mainContextTypeId][relationalContextTypeId][key] = {p, owner};
+    addHandle(*newSnapshot, owner, {false, true, false, false, false, mainContextTypeId, relationalContextTypeId, 0, key});
+    endWrite();
 }
 
 void PlaceholderRegistry::registerCachedRelationalPlaceholder(
@@ -174,25 +509,26 @@ void PlaceholderRegistry::registerCachedRelationalPlaceholder(
 
     std::string key = buildKey(prefix, p->token());
 
-    std::lock_guard<std::mutex> lk(mWriteMutex);
-    auto                        newSnapshot = std::make_shared<Snapshot>(*mSnapshot.load());
+    std::lock_guard<std::recursive_mutex> lk(mWriteMutex);
+    Snapshot*                             newSnapshot = beginWrite();
+    markDirty(key);
 
-    CachedEntry entry;
-    entry.ptr           = p;
-    entry.owner         = owner;
-    entry.cacheDuration = cacheDuration;
+    auto entry = makeCachedEntry(p, owner, cacheDuration, false);
 
-    auto& cachedRelationalMap = newSnapshot->cached_relational[mainContextTypeId][relationalContextTypeId];
-    bool  hadExisting         = cachedRelationalMap.contains(key);
+    const auto* cachedMain  = newSnapshot->cached_relational.find(mainContextTypeId);
+    const auto* cachedRel   = cachedMain ? cachedMain->find(relationalContextTypeId) : nullptr;
+    bool        hadExisting = cachedRel && cachedRel->contains(key);
+    if (cachedRel) {
+        retireCachedEntry(cachedRel->find(key));
+    }
 
-    auto relationalMainIt = newSnapshot->relational.find(mainContextTypeId);
-    if (relationalMainIt != newSnapshot->relational.end()) {
-        auto relationalIt = relationalMainIt->second.find(relationalContextTypeId);
-        if (relationalIt != relationalMainIt->second.end()) {
-            hadExisting = relationalIt->second.erase(key) > 0 || hadExisting;
-            if (relationalIt->second.empty()) relationalMainIt->second.erase(relationalIt);
-            if (relationalMainIt->second.empty()) newSnapshot->relational.erase(relationalMainIt);
-        }
+    const auto* relationalMain = newSnapshot->relational.find(mainContextTypeId);
+    const auto* relationalMap  = relationalMain ? relationalMain->find(relationalContextTypeId) : nullptr;
+    if (relationalMap && relationalMap->contains(key)) {
+        hadExisting = true;
+        auto& main  = newSnapshot->relational[mainContextTypeId];
+        eraseNested(main, relationalContextTypeId, key);
+        if (main.empty()) newSnapshot->relational.erase(mainContextTypeId);
     }
 
     if (hadExisting) {
@@ -204,11 +540,9 @@ void PlaceholderRegistry::registerCachedRelationalPlaceholder(
         );
     }
 
-    cachedRelationalMap[key] = std::move(entry);
-    newSnapshot->ownerIndex[owner].push_back(
-        {false, true, true, false, false, mainContextTypeId, relationalContextTypeId, 0, key}
-    );
-    mSnapshot.store(newSnapshot);
+    newSnapshot->cached_relational[mainContextTypeId][relationalContextTypeId][key] = std::move(entry);
+    addHandle(*newSnapshot, owner, {false, true, true, false, false, mainContextTypeId, relationalContextTypeId, 0, key});
+    endWrite();
 }
 
 void PlaceholderRegistry::registerContextAlias(
@@ -222,14 +556,22 @@ void PlaceholderRegistry::registerContextAlias(
 
     std::string key = toLowerKey(alias);
 
-    std::lock_guard<std::mutex> lk(mWriteMutex);
-    auto                        current = mSnapshot.load();
-    auto                        snap    = std::make_shared<Snapshot>(*current);
+    std::lock_guard<std::recursive_mutex> lk(mWriteMutex);
+    Snapshot*                             snap = beginWrite();
+    markDirty(key);
 
     auto& vec = snap->adapters[key];
-    vec.push_back(Adapter{fromContextTypeId, toContextTypeId, resolver, owner});
+    vec.push_back(Adapter{
+        fromContextTypeId,
+        toContextTypeId,
+        resolver,
+        owner,
+        std::make_shared<AdapterAliasPlaceholder>(key, fromContextTypeId, toContextTypeId, resolver, *this)
+    });
 
-    snap->ownerIndex[owner].push_back(
+    addHandle(
+        *snap,
+        owner,
         {false, // isServer
          false, // isRelational
          false, // isCached
@@ -241,19 +583,20 @@ void PlaceholderRegistry::registerContextAlias(
          key}
     );
 
-    mSnapshot.store(snap);
+    endWrite();
 }
 
 void PlaceholderRegistry::registerContextFactory(uint64_t contextTypeId, ContextFactoryFn factory, void* owner) {
     if (!factory) return;
 
-    std::lock_guard<std::mutex> lk(mWriteMutex);
-    auto                        current = mSnapshot.load();
-    auto                        snap    = std::make_shared<Snapshot>(*current);
+    std::lock_guard<std::recursive_mutex> lk(mWriteMutex);
+    Snapshot*                             snap = beginWrite();
 
     snap->contextFactories[contextTypeId] = {factory, owner};
 
-    snap->ownerIndex[owner].push_back(
+    addHandle(
+        *snap,
+        owner,
         {false, // isServer
          false, // isRelational
          false, // isCached
@@ -265,27 +608,54 @@ void PlaceholderRegistry::registerContextFactory(uint64_t contextTypeId, Context
          std::to_string(contextTypeId)}
     );
 
-    mSnapshot.store(snap);
+    endWrite();
 }
 
 void PlaceholderRegistry::unregisterByOwner(void* owner) {
-    std::lock_guard<std::mutex> lk(mWriteMutex);
-    auto                        currentSnapshot = mSnapshot.load();
-    auto                        it              = currentSnapshot->ownerIndex.find(owner);
-    if (it == currentSnapshot->ownerIndex.end()) return;
+    std::lock_guard<std::recursive_mutex> lk(mWriteMutex);
+    {
+        // 批处理中以待发布快照为准；owner 没有任何注册时不复制快照
+        std::shared_ptr<const Snapshot> current = mBatchDepth > 0 ? mPending : mPublished;
+        if (!current->ownerIndex.contains(owner)) return;
+    }
+
+    Snapshot*  newSnapshot = beginWrite();
+    HandleList handles     = *newSnapshot->ownerIndex.find(owner);
+    newSnapshot->ownerIndex.erase(owner);
 
-    auto newSnapshot = std::make_shared<Snapshot>(*currentSnapshot);
+    // 删除两层嵌套映射 outer[mainId][relId][token]，空的内层映射一并删除
+    auto eraseRelational = [&](auto& outer, const Handle& h) {
+        const auto* main  = outer.find(h.mainCtxId);
+        const auto* inner = main ? main->find(h.relCtxId) : nullptr;
+        const auto* entry = inner ? inner->find(h.token) : nullptr;
+        if (!ownedBy(entry, owner)) return;
+        retireCachedEntry(entry);
+        auto& mainMap = outer[h.mainCtxId];
+        eraseNested(mainMap, h.relCtxId, h.token);
+        if (mainMap.empty()) outer.erase(h.mainCtxId);
+    };
+    auto eraseTyped = [&](auto& outer, const Handle& h) {
+        const auto* inner = outer.find(h.ctxId);
+        const auto* entry = inner ? inner->find(h.token) : nullptr;
+        if (ownedBy(entry, owner)) {
+            retireCachedEntry(entry);
+            eraseNested(outer, h.ctxId, h.token);
+        }
+    };
 
-    for (const Handle& h : it->second) {
+    for (const HandleNode* node = handles.get(); node; node = node->next.get()) {
+        const Handle& h = node->handle;
+        if (!h.isFactory) {
+            markDirty(h.token);
+        }
         if (h.isFactory) {
-            auto fit = newSnapshot->contextFactories.find(h.ctxId);
-            if (fit != newSnapshot->contextFactories.end() && fit->second.owner == owner) {
-                newSnapshot->contextFactories.erase(fit);
+            if (ownedBy(newSnapshot->contextFactories.find(h.ctxId), owner)) {
+                newSnapshot->contextFactories.erase(h.ctxId);
             }
         } else if (h.isAdapter) {
-            auto ait = newSnapshot->adapters.find(h.token);
-            if (ait != newSnapshot->adapters.end()) {
-                auto& vec = ait->second;
+            const auto* adapters = newSnapshot->adapters.find(h.token);
+            if (adapters) {
+                auto vec = *adapters;
                 vec.erase(
                     std::remove_if(
                         vec.begin(),
@@ -297,98 +667,57 @@ void PlaceholderRegistry::unregisterByOwner(void* owner) {
                     vec.end()
                 );
                 if (vec.empty()) {
-                    newSnapshot->adapters.erase(ait);
+                    newSnapshot->adapters.erase(h.token);
+                } else {
+                    newSnapshot->adapters[h.token] = std::move(vec);
                 }
             }
         } else if (h.isCached) {
             if (h.isServer) {
-                auto sit = newSnapshot->cached_server.find(h.token);
-                if (sit != newSnapshot->cached_server.end() && sit->second.owner == owner) {
-                    newSnapshot->cached_server.erase(sit);
+                const auto* entry = newSnapshot->cached_server.find(h.token);
+                if (ownedBy(entry, owner)) {
+                    retireCachedEntry(entry);
+                    newSnapshot->cached_server.erase(h.token);
                 }
             } else if (h.isRelational) {
-                auto mainIt = newSnapshot->cached_relational.find(h.mainCtxId);
-                if (mainIt != newSnapshot->cached_relational.end()) {
-                    auto relIt = mainIt->second.find(h.relCtxId);
-                    if (relIt != mainIt->second.end()) {
-                        auto pit = relIt->second.find(h.token);
-                        if (pit != relIt->second.end() && pit->second.owner == owner) {
-                            relIt->second.erase(pit);
-                            if (relIt->second.empty()) mainIt->second.erase(relIt);
-                            if (mainIt->second.empty()) newSnapshot->cached_relational.erase(mainIt);
-                        }
-                    }
-                }
+                eraseRelational(newSnapshot->cached_relational, h);
             } else {
-                auto tit = newSnapshot->cached_typed.find(h.ctxId);
-                if (tit != newSnapshot->cached_typed.end()) {
-                    auto pit = tit->second.find(h.token);
-                    if (pit != tit->second.end() && pit->second.owner == owner) {
-                        tit->second.erase(pit);
-                        if (tit->second.empty()) newSnapshot->cached_typed.erase(tit);
-                    }
-                }
+                eraseTyped(newSnapshot->cached_typed, h);
             }
         } else if (h.isServer) {
-            auto sit = newSnapshot->server.find(h.token);
-            if (sit != newSnapshot->server.end() && sit->second.owner == owner) {
-                newSnapshot->server.erase(sit);
+            if (ownedBy(newSnapshot->server.find(h.token), owner)) {
+                newSnapshot->server.erase(h.token);
             }
         } else if (h.isRelational) {
-            auto mainIt = newSnapshot->relational.find(h.mainCtxId);
-            if (mainIt != newSnapshot->relational.end()) {
-                auto relIt = mainIt->second.find(h.relCtxId);
-                if (relIt != mainIt->second.end()) {
-                    auto pit = relIt->second.find(h.token);
-                    if (pit != relIt->second.end() && pit->second.owner == owner) {
-                        relIt->second.erase(pit);
-                        if (relIt->second.empty()) mainIt->second.erase(relIt);
-                        if (mainIt->second.empty()) newSnapshot->relational.erase(mainIt);
-                    }
-                }
-            }
+            eraseRelational(newSnapshot->relational, h);
         } else { // Typed (non-cached)
-            auto tit = newSnapshot->typed.find(h.ctxId);
-            if (tit != newSnapshot->typed.end()) {
-                auto pit = tit->second.find(h.token);
-                if (pit != tit->second.end() && pit->second.owner == owner) {
-                    tit->second.erase(pit);
-                    if (tit->second.empty()) newSnapshot->typed.erase(tit);
-                }
-            }
+            eraseTyped(newSnapshot->typed, h);
         }
     }
-    newSnapshot->ownerIndex.erase(owner);
-    mSnapshot.store(newSnapshot);
+    endWrite();
 }
 
 std::vector<std::pair<std::string, std::shared_ptr<const IPlaceholder>>>
 PlaceholderRegistry::getTypedPlaceholders(const IContext* ctx) const {
-    auto                                                                     snapshot = mSnapshot.load();
+    RegistryReadGuard                                                        guard(*this);
+    const Snapshot*                                                          snapshot = guard.mSnapshot;
     std::vector<std::pair<std::string, std::shared_ptr<const IPlaceholder>>> typedList;
     if (!ctx) return typedList;
 
     std::unordered_map<std::string, std::shared_ptr<const IPlaceholder>> tempTypedMap;
     const auto& inheritedTypeIds = ctx->getInheritedTypeIds(); // 已按派生优先排序
 
+    auto collect = [&](const std::string& key, const Entry& entry) { tempTypedMap.try_emplace(key, entry.ptr); };
     for (uint64_t id : inheritedTypeIds) {
-        auto tit = snapshot->typed.find(id);
-        if (tit != snapshot->typed.end()) {
-            for (auto& kv : tit->second) {
-                tempTypedMap.try_emplace(kv.first, kv.second.ptr);
-            }
+        if (const auto* inner = snapshot->typed.find(id)) {
+            inner->forEach(collect);
         }
     }
 
-    uint64_t mainCtxId = ctx->typeId();
-    auto     mainIt    = snapshot->relational.find(mainCtxId);
-    if (mainIt != snapshot->relational.end()) {
+    if (const auto* main = snapshot->relational.find(ctx->typeId())) {
         for (uint64_t relId : inheritedTypeIds) {
-            auto relIt = mainIt->second.find(relId);
-            if (relIt != mainIt->second.end()) {
-                for (auto& kv : relIt->second) {
-                    tempTypedMap.try_emplace(kv.first, kv.second.ptr);
-                }
+            if (const auto* inner = main->find(relId)) {
+                inner->forEach(collect);
             }
         }
     }
@@ -403,116 +732,122 @@ PlaceholderRegistry::getTypedPlaceholders(const IContext* ctx) const {
 
 std::vector<std::pair<std::string, std::shared_ptr<const IPlaceholder>>>
 PlaceholderRegistry::getServerPlaceholders() const {
-    auto                                                                     snapshot = mSnapshot.load();
+    RegistryReadGuard                                                        guard(*this);
+    const Snapshot*                                                          snapshot = guard.mSnapshot;
     std::vector<std::pair<std::string, std::shared_ptr<const IPlaceholder>>> serverList;
     serverList.reserve(snapshot->server.size());
-    for (auto& kv : snapshot->server) {
-        serverList.emplace_back(kv.first, kv.second.ptr);
-    }
+    snapshot->server.forEach([&](const std::string& key, const Entry& entry) {
+        serverList.emplace_back(key, entry.ptr);
+    });
     return serverList;
 }
 
-LookupResult PlaceholderRegistry::findPlaceholder(const std::string& token, const IContext* ctx) const {
-    auto        snapshot   = mSnapshot.load();
-    std::string lowerToken = toLowerKey(token);
-
-    if (ctx) {
-        const auto& inheritedTypeIds = ctx->getInheritedTypeIds(); // 已按派生优先排序
-
-        // 1. Check context alias (adapter) by token == alias
-        {
-            auto ait = snapshot->adapters.find(lowerToken);
-            if (ait != snapshot->adapters.end()) {
-                for (uint64_t id : inheritedTypeIds) {
-                    for (const auto& ad : ait->second) {
-                        if (ad.fromCtxId == id) {
-                            auto aliasPh = std::make_shared<AdapterAliasPlaceholder>(
-                                token,
-                                ad.fromCtxId,
-                                ad.toCtxId,
-                                ad.resolver,
-                                *this
-                            );
-                            return {aliasPh, nullptr, snapshot};
-                        }
-                    }
-                }
-            }
-        }
-
-        // 2. Check cached typed placeholders
-        for (uint64_t id : inheritedTypeIds) {
-            auto it = snapshot->cached_typed.find(id);
-            if (it != snapshot->cached_typed.end()) {
-                auto placeholderIt = it->second.find(lowerToken);
-                if (placeholderIt != it->second.end()) {
-                    return {placeholderIt->second.ptr, &placeholderIt->second, snapshot};
-                }
-            }
-        }
+const PlaceholderRegistry::ResolvedEntry* PlaceholderRegistry::lookupLongest(
+    const Snapshot&  snapshot,
+    std::string_view tokenSearchPart,
+    const IContext*  ctx,
+    size_t&          tokenLength
+) const {
+    const auto& table = tableFor(snapshot, ctx);
+
+    // 结果只取决于前 limit + 1 个字符（第 limit 个字符决定该处是否为 ':' 边界）
+    const size_t     limit  = std::min(tokenSearchPart.length(), table.maxKeyLength);
+    std::string_view region = tokenSearchPart.substr(0, limit + 1);
+
+    // 任何可能命中的 token 都与 region 有相同的首段：首段不在过滤器中即可直接拒绝
+    size_t   firstEnd = 0;
+    uint64_t hash     = TokenHash::kOffsetBasis;
+    while (firstEnd < limit && region[firstEnd] != ':') {
+        hash = TokenHash::step(hash, static_cast<unsigned char>(region[firstEnd++]));
+    }
+    if (firstEnd == limit && firstEnd < region.length() && region[firstEnd] != ':') {
+        return nullptr; // 首段比最长的 key 还长
+    }
+    if (!table.firstSegments.mayContain(hash)) {
+        return nullptr;
+    }
 
-        // 3. Check non-cached typed placeholders
-        for (uint64_t id : inheritedTypeIds) {
-            auto it = snapshot->typed.find(id);
-            if (it != snapshot->typed.end()) {
-                auto placeholderIt = it->second.find(lowerToken);
-                if (placeholderIt != it->second.end()) {
-                    return {placeholderIt->second.ptr, nullptr, snapshot};
-                }
-            }
-        }
+    // 首段存在但整体未命中的内容（如 {papi:未注册}）记入否定缓存
+    uint64_t fingerprint = kMissFingerprintSeed;
+    for (unsigned char c : region) {
+        fingerprint = TokenHash::step(fingerprint, c);
+    }
+    if (table.misses.contains(fingerprint)) {
+        return nullptr;
+    }
 
-        // 4. Check cached relational placeholders
-        uint64_t mainCtxId = ctx->typeId();
-        auto     mainIt    = snapshot->cached_relational.find(mainCtxId);
-        if (mainIt != snapshot->cached_relational.end()) {
-            for (uint64_t relId : inheritedTypeIds) {
-                auto relIt = mainIt->second.find(relId);
-                if (relIt != mainIt->second.end()) {
-                    auto placeholderIt = relIt->second.find(lowerToken);
-                    if (placeholderIt != relIt->second.end()) {
-                        return {placeholderIt->second.ptr, &placeholderIt->second, snapshot};
-                    }
-                }
+    // 从左到右累加前缀哈希，在每个 ':' 与末尾处探测一次，最后一次命中即最长 token
+    const ResolvedEntry* best     = nullptr;
+    size_t               segments = 0;
+    hash                          = TokenHash::kOffsetBasis;
+    for (size_t i = 0; i <= limit; ++i) {
+        if (i == tokenSearchPart.length() || tokenSearchPart[i] == ':') {
+            if (const auto* resolved = table.entries.find(tokenSearchPart.substr(0, i), static_cast<size_t>(hash))) {
+                best        = resolved;
+                tokenLength = i;
             }
+            if (++segments >= table.maxSegments) break;
         }
+        if (i < limit) hash = TokenHash::step(hash, static_cast<unsigned char>(tokenSearchPart[i]));
+    }
+    if (!best) {
+        table.misses.insert(fingerprint);
+    }
+    return best;
+}
 
-        // 5. Check non-cached relational placeholders
-        auto mainItNonCached = snapshot->relational.find(mainCtxId);
-        if (mainItNonCached != snapshot->relational.end()) {
-            for (uint64_t relId : inheritedTypeIds) {
-                auto relIt = mainItNonCached->second.find(relId);
-                if (relIt != mainItNonCached->second.end()) {
-                    auto placeholderIt = relIt->second.find(lowerToken);
-                    if (placeholderIt != relIt->second.end()) {
-                        return {placeholderIt->second.ptr, nullptr, snapshot};
-                    }
-                }
-            }
-        }
+BorrowedLookup PlaceholderRegistry::findPlaceholder(
+    const RegistryReadGuard& guard,
+    std::string_view         token,
+    const IContext*          ctx
+) const {
+    const ResolvedEntry* resolved = tableFor(*guard.mSnapshot, ctx).entries.find(token);
+    if (!resolved) {
+        return {};
     }
+    return {resolved->placeholder.get(), resolved->entry.get(), resolved->extended};
+}
 
-    // 6. Check cached server placeholders
-    auto cachedServerIt = snapshot->cached_server.find(lowerToken);
-    if (cachedServerIt != snapshot->cached_server.end()) {
-        return {cachedServerIt->second.ptr, &cachedServerIt->second, snapshot};
+BorrowedLookup PlaceholderRegistry::findLongestPlaceholder(
+    const RegistryReadGuard& guard,
+    std::string_view         tokenSearchPart,
+    const IContext*          ctx,
+    size_t&                  tokenLength
+) const {
+    const ResolvedEntry* resolved = lookupLongest(*guard.mSnapshot, tokenSearchPart, ctx, tokenLength);
+    if (!resolved) {
+        return {};
     }
+    return {resolved->placeholder.get(), resolved->entry.get(), resolved->extended};
+}
 
-    // 7. Check non-cached server placeholders
-    auto serverIt = snapshot->server.find(lowerToken);
-    if (serverIt != snapshot->server.end()) {
-        return {serverIt->second.ptr, nullptr, snapshot};
+LookupResult PlaceholderRegistry::findPlaceholder(std::string_view token, const IContext* ctx) const {
+    RegistryReadGuard guard(*this);
+    auto              found = findPlaceholder(guard, token, ctx);
+    if (!found.placeholder) {
+        return {nullptr, nullptr, nullptr};
     }
+    // 别名构造：返回的占位符指针与 snapshot_guard 共用快照的引用计数
+    auto snapshot = guard.retain();
+    return {std::shared_ptr<const IPlaceholder>(snapshot, found.placeholder), found.entry, std::move(snapshot)};
+}
 
-    return {nullptr, nullptr, nullptr};
+LookupResult PlaceholderRegistry::findLongestPlaceholder(
+    std::string_view tokenSearchPart, const IContext* ctx, size_t& tokenLength
+) const {
+    RegistryReadGuard guard(*this);
+    auto              found = findLongestPlaceholder(guard, tokenSearchPart, ctx, tokenLength);
+    if (!found.placeholder) {
+        return {nullptr, nullptr, nullptr};
+    }
+    auto snapshot = guard.retain();
+    return {std::shared_ptr<const IPlaceholder>(snapshot, found.placeholder), found.entry, std::move(snapshot)};
 }
 
 std::optional<Adapter> PlaceholderRegistry::findContextAlias(std::string_view alias, uint64_t fromContextTypeId) const {
-    auto        snapshot   = mSnapshot.load();
-    std::string lowerAlias = toLowerKey(alias);
-    auto        it         = snapshot->adapters.find(lowerAlias);
-    if (it != snapshot->adapters.end()) {
-        for (const auto& adapter : it->second) {
+    RegistryReadGuard guard(*this);
+    if (const auto* adapters = guard.mSnapshot->adapters.find(alias)) {
+        for (const auto& adapter : *adapters) {
             if (adapter.fromCtxId == fromContextTypeId) {
                 return adapter; // 返回值拷贝，snapshot 生命周期不再影响调用方
             }
@@ -522,12 +857,9 @@ std::optional<Adapter> PlaceholderRegistry::findContextAlias(std::string_view al
 }
 
 ContextFactoryFn PlaceholderRegistry::findContextFactory(uint64_t contextTypeId) const {
-    auto snapshot = mSnapshot.load();
-    auto it       = snapshot->contextFactories.find(contextTypeId);
-    if (it != snapshot->contextFactories.end()) {
-        return it->second.factory;
-    }
-    return nullptr;
+    RegistryReadGuard guard(*this);
+    const auto*       entry = guard.mSnapshot->contextFactories.find(contextTypeId);
+    return entry ? entry->factory : nullptr;
 }
 
 // ScopedPlaceholderRegistrar implementation
@@ -1,6 +1,10 @@
 // src/PA/PlaceholderRegistry.h
 #pragma once
 
+#include "PA/EpochDomain.h"
+#include "PA/LookupFilters.h"
+#include "PA/PersistentHashMap.h"
+#include "PA/PlaceholderCacheStore.h"
 #include "PA/PlaceholderAPI.h"
 #include <atomic>
 #include <memory>
@@ -14,48 +18,77 @@
 
 namespace PA {
 
+// ASCII 小写折叠，与注册时 buildKey 的规范化规则一致
+constexpr unsigned char foldTokenChar(unsigned char c) noexcept {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+}
+
+// 大小写不敏感的 token 哈希，支持以 string_view 异构查找
+struct TokenHash {
+    using is_transparent = void;
+
+    static constexpr uint64_t kOffsetBasis = 14695981039346656037ull;
+
+    // 逐字符累加（FNV-1a），调用方可在一次遍历中得到每个前缀的哈希
+    static constexpr uint64_t step(uint64_t hash, unsigned char c) noexcept {
+        return (hash ^ foldTokenChar(c)) * 1099511628211ull;
+    }
+
+    size_t operator()(std::string_view s) const noexcept {
+        uint64_t hash = kOffsetBasis;
+        for (unsigned char c : s) {
+            hash = step(hash, c);
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+// 大小写不敏感的 token 比较，与 TokenHash 配套
+struct TokenEqual {
+    using is_transparent = void;
+
+    bool operator()(std::string_view a, std::string_view b) const noexcept {
+        if (a.length() != b.length()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.length(); ++i) {
+            if (foldTokenChar(static_cast<unsigned char>(a[i])) != foldTokenChar(static_cast<unsigned char>(b[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// 以 token 为 key 的映射：key 仍以小写存储，查找时无需再构造小写副本
+template <typename T>
+using TokenMap = std::unordered_map<std::string, T, TokenHash, TokenEqual>;
+
+// 快照使用的持久化映射：发布新快照时只复制修改路径，其余节点与旧快照共享
+template <typename T>
+using PersistentTokenMap = PersistentHashMap<std::string, T, TokenHash, TokenEqual>;
+
+template <typename T>
+using PersistentIdMap = PersistentHashMap<uint64_t, T>;
+
 // 别名适配器条目
 struct Adapter {
-    uint64_t          fromCtxId{};
-    uint64_t          toCtxId{};
-    ContextResolverFn resolver{};
-    void*             owner{};
+    uint64_t                            fromCtxId{};
+    uint64_t                            toCtxId{};
+    ContextResolverFn                   resolver{};
+    void*                               owner{};
+    std::shared_ptr<const IPlaceholder> placeholder{}; // 注册时预先创建的别名占位符，查找命中时直接复用
 };
 
 // 将 CachedEntry 结构体移到类外部，使其在 findPlaceholder 声明时可见
+// 缓存值保存在注册表的 PlaceholderCacheStore 中，条目只记录其 id，因此可被各版本快照共享
 struct CachedEntry {
     std::shared_ptr<const IPlaceholder> ptr{};
     void*                               owner{};
     unsigned int                        cacheDuration{}; // 缓存持续时间（秒）
-
-    // 内部缓存值结构体
-    struct Value {
-        std::string                           value;
-        std::chrono::steady_clock::time_point lastEvaluated;
-    };
-
-    // 线程安全的缓存存储
-    // Key: context_instance_key + ":" + args_key
-    mutable std::mutex                                  cacheMutex;
-    mutable std::unordered_map<std::string, Value>      cachedValues;
-
-    CachedEntry() = default;
-    CachedEntry(CachedEntry&& other) noexcept
-        : ptr(std::move(other.ptr)), owner(other.owner), cacheDuration(other.cacheDuration),
-          cachedValues(std::move(other.cachedValues)) {}
-    CachedEntry& operator=(CachedEntry&& other) noexcept {
-        if (this != &other) {
-            ptr           = std::move(other.ptr);
-            owner         = other.owner;
-            cacheDuration = other.cacheDuration;
-            cachedValues  = std::move(other.cachedValues);
-        }
-        return *this;
-    }
-
-    // Delete copy constructor and copy assignment operator
-    CachedEntry(const CachedEntry&) = delete;
-    CachedEntry& operator=(const CachedEntry&) = delete;
+    uint64_t                            cacheId{};       // 在 store 中的稳定 id，注册时分配，反注册或覆盖时释放
+    PlaceholderCacheStore*              store{};         // 由快照持有，生命周期不短于条目
+    bool                                serverLevel{};   // 服务器级值不依赖上下文，所有实例共用 instanceId 为 0 的一份
 };
 
 class PlaceholderRegistry; // Forward declaration
@@ -66,6 +99,15 @@ struct LookupResult {
     std::shared_ptr<const void>         snapshot_guard;
 };
 
+// RegistryReadGuard 内的查找结果：指针借用自读保护锁定的快照，仅在该读保护存活期间有效
+struct BorrowedLookup {
+    const IPlaceholder*         placeholder = nullptr;
+    const CachedEntry*          entry       = nullptr;
+    const IExtendedPlaceholder* extended    = nullptr; // placeholder 实现了 IExtendedPlaceholder 时指向它
+};
+
+class RegistryReadGuard;
+
 // ScopedPlaceholderRegistrar 的实现
 class ScopedPlaceholderRegistrar : public IScopedPlaceholderRegistrar {
 public:
@@ -131,6 +173,17 @@ class PlaceholderRegistry {
     );
     void unregisterByOwner(void* owner);
 
+    /**
+     * @brief 开始批量注册
+     * 之后同一线程上的注册/反注册都作用于同一份私有快照，直到配对的 commitBatch() 才发布一次。
+     * 批处理期间持有写锁，其他线程的注册会等待；读取不受影响，看到的仍是批处理开始前的快照。
+     * 可嵌套，必须与 commitBatch() 在同一线程上成对调用。
+     */
+    void beginBatch();
+
+    // 结束批量注册；最外层提交时若有修改则发布新快照
+    void commitBatch();
+
     // 注册上下文别名适配器（例如 look/last_hit 等）
     void registerContextAlias(
         std::string_view  alias,
@@ -148,7 +201,26 @@ class PlaceholderRegistry {
     std::vector<std::pair<std::string, std::shared_ptr<const IPlaceholder>>> getServerPlaceholders() const;
 
     // 修改 findPlaceholder 的返回类型，以支持缓存
-    LookupResult findPlaceholder(const std::string& token, const IContext* ctx) const;
+    // token 大小写不敏感；命中时不产生任何堆分配
+    LookupResult findPlaceholder(std::string_view token, const IContext* ctx) const;
+
+    // 在 guard 锁定的快照中查找，不产生任何引用计数操作
+    BorrowedLookup findPlaceholder(const RegistryReadGuard& guard, std::string_view token, const IContext* ctx) const;
+
+    /**
+     * @brief 在 tokenSearchPart（占位符内容中 '|' 之前的部分）中查找最长的已注册 token
+     * 单次遍历累加前缀哈希，只在 ':' 边界处探测；段数与长度超出已注册 key 的上限即停止，开销与参数中 ':' 的数量无关
+     * @param tokenLength 命中时写入 token 长度；若小于 tokenSearchPart 长度，该位置为分隔参数的 ':'
+     */
+    LookupResult
+    findLongestPlaceholder(std::string_view tokenSearchPart, const IContext* ctx, size_t& tokenLength) const;
+
+    BorrowedLookup findLongestPlaceholder(
+        const RegistryReadGuard& guard,
+        std::string_view         tokenSearchPart,
+        const IContext*          ctx,
+        size_t&                  tokenLength
+    ) const;
 
     // 查找上下文别名（返回值拷贝，避免 snapshot 生命周期问题）
     std::optional<Adapter> findContextAlias(std::string_view alias, uint64_t fromContextTypeId) const;
@@ -156,7 +228,15 @@ class PlaceholderRegistry {
     // 查找上下文工厂
     ContextFactoryFn findContextFactory(uint64_t contextTypeId) const;
 
+    // 当前快照版本号：每次发布新快照递增，用于判断预编译模板的绑定是否过期
+    uint64_t getVersion() const;
+
+    // 所有快照共享的缓存值存储，用于配置上限与查询统计
+    PlaceholderCacheStore& getCacheStore() const { return *mCacheStore; }
+
 private:
+    friend class RegistryReadGuard;
+
     struct Entry {
         std::shared_ptr<const IPlaceholder> ptr{};
         void*                               owner{};
@@ -174,92 +254,209 @@ class PlaceholderRegistry {
         std::string token; // 对于适配器，这里存 alias; 对于工厂，这里存 ctxId 的字符串形式
     };
 
+    // 解析表条目的来源，仅用于调试输出
+    enum class ResolvedKind : uint8_t { Alias, CachedTyped, Typed, CachedRelational, Relational, CachedServer, Server };
+
+    struct ResolvedEntry {
+        std::shared_ptr<const IPlaceholder> placeholder;
+        std::shared_ptr<const CachedEntry>  entry;
+        ResolvedKind                        kind{};
+        const IExtendedPlaceholder*         extended{}; // 写入解析表时检测一次，查找时不再 dynamic_cast
+    };
+
+    // owner 的注册记录以共享尾部的单链表保存，追加一条只需新建一个节点
+    struct HandleNode {
+        Handle                            handle;
+        std::shared_ptr<const HandleNode> next;
+    };
+    using HandleList = std::shared_ptr<const HandleNode>;
+
+    // 某一具体上下文类型可见的全部 token，优先级已在构建时应用，查找只需一次哈希探测
+    // 发布新快照时只重新解析本次修改涉及的 key，其余条目与上一版本共享
+    // 首段布隆过滤器与否定缓存让聊天文本、JSON 中大量并非占位符的 {...}、%...% 不必逐段探测哈希表
+    struct ResolutionTable {
+        PersistentTokenMap<ResolvedEntry> entries;
+        size_t                            maxKeyLength{}; // 最长 key 的长度
+        size_t                            maxSegments{};  // key 按 ':' 分段的最大段数；删除时不回收，只会偏大
+        BloomFilter                       firstSegments;  // 所有 key 第一个 ':' 之前部分的 TokenHash
+        mutable NegativeLookupCache       misses;         // 最近未命中的查找；每次发布都会构建新表，随之清空
+
+        void assign(const std::string& key, ResolvedEntry resolved);
+        void rebuildFilter();
+    };
+
+    using ResolutionTableSet = std::unordered_map<uint64_t, std::shared_ptr<const ResolutionTable>>;
+
     // 构建注册表 key：去花括号 + 拼 prefix + 转小写
     static std::string buildKey(std::string_view prefix, std::string_view token);
 
     // 将字符串转为小写（用于大小写不敏感查找）
     static std::string toLowerKey(std::string_view s);
 
-    struct Snapshot {
-        std::unordered_map<uint64_t, std::unordered_map<std::string, Entry>> typed;
-        std::unordered_map<
-            uint64_t,
-            std::unordered_map<uint64_t, std::unordered_map<std::string, Entry>>>
-                                                  relational;
-        std::unordered_map<std::string, Entry>    server;
-        std::unordered_map<uint64_t, std::unordered_map<std::string, CachedEntry>>
-            cached_typed; // 缓存的 Typed 占位符
-        std::unordered_map<
-            uint64_t,
-            std::unordered_map<uint64_t, std::unordered_map<std::string, CachedEntry>>>
-            cached_relational; // 缓存的关系型占位符
-        std::unordered_map<std::string, CachedEntry> cached_server; // 缓存的 Server 占位符
+    struct Snapshot : std::enable_shared_from_this<Snapshot> {
+        PersistentIdMap<PersistentTokenMap<Entry>>                  typed;
+        PersistentIdMap<PersistentIdMap<PersistentTokenMap<Entry>>> relational;
+        PersistentTokenMap<Entry>                                   server;
+        // 缓存占位符的条目由各版本快照共享，缓存值不随快照复制
+        PersistentIdMap<PersistentTokenMap<std::shared_ptr<CachedEntry>>> cached_typed; // 缓存的 Typed 占位符
+        PersistentIdMap<PersistentIdMap<PersistentTokenMap<std::shared_ptr<CachedEntry>>>>
+                                                        cached_relational; // 缓存的关系型占位符
+        PersistentTokenMap<std::shared_ptr<CachedEntry>> cached_server;     // 缓存的 Server 占位符
 
         // alias -> adapters（key 已预规范化为小写）
-        std::unordered_map<std::string, std::vector<Adapter>> adapters;
+        PersistentTokenMap<std::vector<Adapter>> adapters;
 
         // contextTypeId -> factory
         struct FactoryEntry {
             ContextFactoryFn factory{};
             void*            owner{};
         };
-        std::unordered_map<uint64_t, FactoryEntry> contextFactories;
+        PersistentIdMap<FactoryEntry> contextFactories;
+
+        PersistentHashMap<void*, HandleList> ownerIndex;
+
+        // 按具体上下文类型预合并的解析表，发布时构建，不随拷贝复制
+        std::shared_ptr<const ResolutionTable> serverTable; // ctx 为 nullptr 时使用
+        mutable std::atomic<const ResolutionTableSet*> tables{nullptr};
+        mutable std::mutex                             tablesMutex; // 仅在首次遇到新的上下文类型时使用
+        mutable std::vector<std::unique_ptr<const ResolutionTableSet>> tableSets; // 持有历次表集合，随快照一起释放
 
-        std::unordered_map<void*, std::vector<Handle>> ownerIndex;
+        std::shared_ptr<PlaceholderCacheStore> cacheStore; // 所有版本共享同一个缓存值存储
+
+        uint64_t version{};
 
         Snapshot() = default;
 
+        // 持久化映射的拷贝只复制根指针，与 other 共享全部节点
         Snapshot(const Snapshot& other)
-        : typed(other.typed),
+        : std::enable_shared_from_this<Snapshot>(),
+          typed(other.typed),
           relational(other.relational),
           server(other.server),
+          cached_typed(other.cached_typed),
+          cached_relational(other.cached_relational),
+          cached_server(other.cached_server),
           adapters(other.adapters),
           contextFactories(other.contextFactories),
-          ownerIndex(other.ownerIndex) {
-            for (const auto& pair : other.cached_typed) {
-                for (const auto& inner_pair : pair.second) {
-                    CachedEntry new_entry;
-                    new_entry.ptr           = inner_pair.second.ptr;
-                    new_entry.owner         = inner_pair.second.owner;
-                    new_entry.cacheDuration = inner_pair.second.cacheDuration;
-                    {
-                        std::lock_guard<std::mutex> lock(inner_pair.second.cacheMutex);
-                        new_entry.cachedValues = inner_pair.second.cachedValues;
-                    }
-                    cached_typed[pair.first].emplace(inner_pair.first, std::move(new_entry));
-                }
-            }
-            for (const auto& pair : other.cached_relational) {
-                for (const auto& inner_pair : pair.second) {
-                    for (const auto& final_pair : inner_pair.second) {
-                        CachedEntry new_entry;
-                        new_entry.ptr           = final_pair.second.ptr;
-                        new_entry.owner         = final_pair.second.owner;
-                        new_entry.cacheDuration = final_pair.second.cacheDuration;
-                        {
-                            std::lock_guard<std::mutex> lock(final_pair.second.cacheMutex);
-                            new_entry.cachedValues = final_pair.second.cachedValues;
-                        }
-                        cached_relational[pair.first][inner_pair.first].emplace(final_pair.first, std::move(new_entry));
-                    }
-                }
-            }
-            for (const auto& pair : other.cached_server) {
-                CachedEntry new_entry;
-                new_entry.ptr           = pair.second.ptr;
-                new_entry.owner         = pair.second.owner;
-                new_entry.cacheDuration = pair.second.cacheDuration;
-                {
-                    std::lock_guard<std::mutex> lock(pair.second.cacheMutex);
-                    new_entry.cachedValues = pair.second.cachedValues;
-                }
-                cached_server.emplace(pair.first, std::move(new_entry));
-            }
-        }
+          ownerIndex(other.ownerIndex),
+          cacheStore(other.cacheStore),
+          version(other.version) {}
     };
 
-    mutable std::mutex                           mWriteMutex;
-    std::atomic<std::shared_ptr<const Snapshot>> mSnapshot;
+    // 发布新快照并递增版本号，同时为已知的上下文类型更新解析表（调用方需持有 mWriteMutex）
+    void publish(std::shared_ptr<Snapshot> snapshot);
+
+    // 获取可写快照：批处理中返回待发布快照，否则复制当前快照（调用方需持有 mWriteMutex）
+    Snapshot* beginWrite();
+
+    // 非批处理时立即发布 beginWrite() 返回的快照；批处理中推迟到 commitBatch()
+    void endWrite();
+
+    // 记录本次写入涉及的 key，发布时只重新解析这些 key（调用方需持有 mWriteMutex）
+    void markDirty(std::string_view key) { mDirtyKeys.emplace_back(key); }
+
+    static void addHandle(Snapshot& snapshot, void* owner, Handle handle);
+
+    // 为新的缓存条目分配 store 中的 id；serverLevel 为 true 时按 IExtendedPlaceholder::getCacheFlags() 启用后台刷新
+    std::shared_ptr<CachedEntry> makeCachedEntry(
+        std::shared_ptr<const IPlaceholder> p,
+        void*                               owner,
+        unsigned int                        cacheDuration,
+        bool                                serverLevel
+    );
+
+    // 被覆盖或反注册的缓存条目在下一次发布后释放其缓存值（调用方需持有 mWriteMutex）
+    void retireCachedEntry(const std::shared_ptr<CachedEntry>* entry) {
+        if (entry) mRetiredCacheIds.push_back((*entry)->cacheId);
+    }
+    void retireCachedEntry(const Entry* /* entry */) {} // 非缓存条目没有缓存值
+
+    /**
+     * @brief 解析单个 key 在某一具体上下文类型下可见的条目
+     * 优先级与原先逐表查找一致：别名 > 缓存类型 > 类型 > 缓存关系 > 关系 > 缓存服务器 > 服务器，
+     * 同一类别内按 inheritedTypeIds 顺序（派生优先）
+     * @param contextTypeId 具体上下文类型，kServerContextId 表示仅包含服务器占位符
+     * @param inheritedTypeIds 该类型的继承链
+     */
+    static std::optional<ResolvedEntry> resolveKey(
+        const Snapshot&              snapshot,
+        std::string_view             key,
+        uint64_t                     contextTypeId,
+        const std::vector<uint64_t>& inheritedTypeIds
+    );
+
+    // 为某一上下文类型完整构建解析表（首次遇到该类型时使用）
+    static std::shared_ptr<const ResolutionTable> buildResolutionTable(
+        const Snapshot&              snapshot,
+        uint64_t                     contextTypeId,
+        const std::vector<uint64_t>& inheritedTypeIds
+    );
+
+    // 以上一版本的解析表为基础，只重新解析 dirtyKeys
+    static std::shared_ptr<const ResolutionTable> updateResolutionTable(
+        const ResolutionTable&          previous,
+        const Snapshot&                 snapshot,
+        uint64_t                        contextTypeId,
+        const std::vector<uint64_t>&    inheritedTypeIds,
+        const std::vector<std::string>& dirtyKeys
+    );
+
+    // 获取 ctx 对应的解析表；首次遇到的上下文类型会即时构建并记住其继承链，之后的快照发布时直接预建
+    const ResolutionTable& tableFor(const Snapshot& snapshot, const IContext* ctx) const;
+
+    const ResolvedEntry* lookupLongest(
+        const Snapshot&  snapshot,
+        std::string_view tokenSearchPart,
+        const IContext*  ctx,
+        size_t&          tokenLength
+    ) const;
+
+    mutable std::recursive_mutex mWriteMutex;
+
+    std::shared_ptr<PlaceholderCacheStore> mCacheStore;
+
+    // 当前快照：读者只在 RegistryReadGuard 内读取该裸指针；所有权由 mPublished 持有，
+    // 被替换的快照交给 EpochDomain，待读者全部离开后才释放引用
+    std::atomic<const Snapshot*>    mSnapshot{nullptr};
+    std::shared_ptr<const Snapshot> mPublished; // 仅在持有 mWriteMutex 时访问
+
+    // 写入中的私有快照，仅在持有 mWriteMutex 时访问
+    std::shared_ptr<Snapshot> mPending;
+    int                       mBatchDepth{};
+    bool                      mPendingDirty{};
+    std::vector<std::string>  mDirtyKeys;       // 自上次发布以来修改过的 key（可重复）
+    std::vector<uint64_t>     mRetiredCacheIds; // 待发布后释放的缓存 id
+
+    // 见过的具体上下文类型 -> 继承链
+    mutable std::mutex                                      mChainsMutex;
+    mutable std::unordered_map<uint64_t, std::vector<uint64_t>> mContextChains;
+};
+
+/**
+ * @brief 注册表读保护
+ * 进入 epoch 临界区并锁定当前快照，持有期间借用的占位符与缓存条目指针始终有效。
+ * 只能在栈上使用，且须在创建它的线程上析构；持有期间不应长时间阻塞，否则会推迟旧快照的回收。
+ * 需要在读保护之外求值时，先用 retain() 固定快照再离开。
+ */
+class RegistryReadGuard {
+public:
+    explicit RegistryReadGuard(const PlaceholderRegistry& registry)
+    : mSnapshot(registry.mSnapshot.load(std::memory_order_seq_cst)) {}
+
+    RegistryReadGuard(const RegistryReadGuard&)            = delete;
+    RegistryReadGuard& operator=(const RegistryReadGuard&) = delete;
+
+    // 锁定快照的版本号
+    uint64_t version() const noexcept { return mSnapshot->version; }
+
+    // 需要在读保护之外继续使用借用的指针时（例如预编译模板的绑定），取得快照的共享引用
+    std::shared_ptr<const void> retain() const { return mSnapshot->shared_from_this(); }
+
+private:
+    friend class PlaceholderRegistry;
+
+    EpochDomain::Guard                   mEpoch; // 必须先于 mSnapshot 初始化
+    const PlaceholderRegistry::Snapshot* mSnapshot;
 };
 
 } // namespace PA
@@ -43,38 +43,38 @@ void registerActorPlaceholders(IPlaceholderService* svc) {
     PA_SIMPLE(svc, owner, ActorContext, "{actor_type_name}", { out = c.actor ? c.actor->getTypeName() : "N/A"; });
 
     // {actor_pos}
-    PA_SIMPLE(svc, owner, ActorContext, "{actor_pos}", {
+    PA_SIMPLE_TICK(svc, owner, ActorContext, "{actor_pos}", {
         out = c.actor ? c.actor->getPosition().toString() : "0,0,0";
     });
 
     // {actor_pos_x}
-    PA_SIMPLE(svc, owner, ActorContext, "{actor_pos_x}", {
-        out = c.actor ? std::to_string(c.actor->getPosition().x) : "0";
+    PA_SIMPLE_TICK_TYPED(svc, owner, ActorContext, "{actor_pos_x}", {
+        out = c.actor ? PlaceholderValue::ofDouble(c.actor->getPosition().x) : PlaceholderValue::ofInt(0);
     });
 
     // {actor_pos_y}
-    PA_SIMPLE(svc, owner, ActorContext, "{actor_pos_y}", {
-        out = c.actor ? std::to_string(c.actor->getPosition().y) : "0";
+    PA_SIMPLE_TICK_TYPED(svc, owner, ActorContext, "{actor_pos_y}", {
+        out = c.actor ? PlaceholderValue::ofDouble(c.actor->getPosition().y) : PlaceholderValue::ofInt(0);
     });
 
     // {actor_pos_z}
-    PA_SIMPLE(svc, owner, ActorContext, "{actor_pos_z}", {
-        out = c.actor ? std::to_string(c.actor->getPosition().z) : "0";
+    PA_SIMPLE_TICK_TYPED(svc, owner, ActorContext, "{actor_pos_z}", {
+        out = c.actor ? PlaceholderValue::ofDouble(c.actor->getPosition().z) : PlaceholderValue::ofInt(0);
     });
 
     // {actor_rotation}
-    PA_SIMPLE(svc, owner, ActorContext, "{actor_rotation}", {
+    PA_SIMPLE_TICK(svc, owner, ActorContext, "{actor_rotation}", {
         out = c.actor ? c.actor->getRotation().toString() : "0,0";
     });
 
     // {actor_rotation_x}
-    PA_SIMPLE(svc, owner, ActorContext, "{actor_rotation_x}", {
-        out = c.actor ? std::to_string(c.actor->getRotation().x) : "0";
+    PA_SIMPLE_TICK_TYPED(svc, owner, ActorContext, "{actor_rotation_x}", {
+        out = c.actor ? PlaceholderValue::ofDouble(c.actor->getRotation().x) : PlaceholderValue::ofInt(0);
     });
 
     // {actor_rotation_y}
-    PA_SIMPLE(svc, owner, ActorContext, "{actor_rotation_y}", {
-        out = c.actor ? std::to_string(c.actor->getRotation().y) : "0";
+    PA_SIMPLE_TICK_TYPED(svc, owner, ActorContext, "{actor_rotation_y}", {
+        out = c.actor ? PlaceholderValue::ofDouble(c.actor->getRotation().y) : PlaceholderValue::ofInt(0);
     });
 
     // {actor_unique_id}
@@ -164,13 +164,13 @@ void registerActorPlaceholders(IPlaceholderService* svc) {
     });
 
     // {actor_max_health}
-    PA_SIMPLE(svc, owner, ActorContext, "{actor_max_health}", {
-        out = c.actor ? std::to_string(c.actor->getMaxHealth()) : "0";
+    PA_SIMPLE_TICK_TYPED(svc, owner, ActorContext, "{actor_max_health}", {
+        out = c.actor ? PlaceholderValue::ofInt(c.actor->getMaxHealth()) : PlaceholderValue::ofInt(0);
     });
 
     // {actor_health}
-    PA_SIMPLE(svc, owner, ActorContext, "{actor_health}", {
-        out = c.actor ? std::to_string(c.actor->getHealth()) : "0";
+    PA_SIMPLE_TICK_TYPED(svc, owner, ActorContext, "{actor_health}", {
+        out = c.actor ? PlaceholderValue::ofInt(c.actor->getHealth()) : PlaceholderValue::ofInt(0);
     });
 
     // {actor_name}
@@ -51,6 +51,23 @@
  *        out = std::to_string(countEntities(excludeDrops));
  *    });
  * 
+ * 7. PA_SERVER_CACHED_FLAGS / PA_SERVER_WITH_ARGS_CACHED_FLAGS - 带缓存并指定刷新策略的服务器级占位符
+ *    示例: PA_SERVER_CACHED_FLAGS(svc, owner, "{server_mod_count}", 60, kCacheRefreshAhead | kCacheStaleWhileRevalidate, {
+ *        out = std::to_string(countMods());
+ *    });
+ * 
+ * 8. PA_SIMPLE_TICK / PA_WITH_ARGS_TICK / PA_SERVER_TICK - 同一游戏刻内值不变的占位符（不缓存）
+ *    在 EvaluationScope 内对同一上下文实例与参数只求值一次
+ *    示例: PA_SIMPLE_TICK(svc, owner, ActorContext, "{actor_health}", {
+ *        out = c.actor ? std::to_string(c.actor->getHealth()) : "0";
+ *    });
+ * 
+ * 9. PA_SIMPLE_TICK_TYPED / PA_WITH_ARGS_TICK_TYPED - 类型化的 tick 稳定占位符
+ *    out 为 PlaceholderValue，数值直接交给条件输出、精度与颜色阈值，文本只生成一次
+ *    示例: PA_SIMPLE_TICK_TYPED(svc, owner, ActorContext, "{actor_health}", {
+ *        out = PlaceholderValue::ofInt(c.actor ? c.actor->getHealth() : 0);
+ *    });
+ * 
  * 注意事项：
  * - owner 参数用于标识占位符归属，建议使用模块内唯一的静态变量地址
  * - cache_duration 单位为秒
@@ -62,20 +79,24 @@ namespace PA {
 
 // 泛型占位符实现（上下文型）
 template <typename Ctx, typename Fn>
-class TypedLambdaPlaceholder final : public PA::IPlaceholder {
+class TypedLambdaPlaceholder final : public PA::IExtendedPlaceholder {
 public:
-    TypedLambdaPlaceholder(std::string token, Fn fn, unsigned int cacheDuration = 0)
+    TypedLambdaPlaceholder(std::string token, Fn fn, unsigned int cacheDuration = 0, bool tickStable = false)
     : token_(std::move(token)),
       fn_(std::move(fn)),
-      cacheDuration_(cacheDuration) {}
+      cacheDuration_(cacheDuration),
+      tickStable_(tickStable) {}
 
     std::string_view token() const noexcept override { return token_; }
     uint64_t         contextTypeId() const noexcept override { return Ctx::kTypeId; }
     unsigned int     getCacheDuration() const noexcept override { return cacheDuration_; }
+    bool             isTickStable() const noexcept override { return tickStable_; }
 
     void evaluate(const PA::IContext* ctx, std::string& out) const override {
         const auto* c = static_cast<const Ctx*>(ctx);
-        if constexpr (std::is_invocable_v<Fn, const Ctx&, std::string&>) {
+        if constexpr (kTyped) {
+            writeText(*c, {}, out);
+        } else if constexpr (std::is_invocable_v<Fn, const Ctx&, std::string&>) {
             fn_(*c, out);
         } else {
             // This placeholder expects arguments, but none were provided.
@@ -87,7 +108,9 @@ class TypedLambdaPlaceholder final : public PA::IPlaceholder {
     void evaluateWithArgs(const PA::IContext* ctx, const std::vector<std::string_view>& args, std::string& out)
         const override {
         const auto* c = static_cast<const Ctx*>(ctx);
-        if constexpr (std::is_invocable_v<Fn, const Ctx&, const std::vector<std::string_view>&, std::string&>) {
+        if constexpr (kTyped) {
+            writeText(*c, args, out);
+        } else if constexpr (std::is_invocable_v<Fn, const Ctx&, const std::vector<std::string_view>&, std::string&>) {
             fn_(*c, args, out);
         } else {
             // This placeholder doesn't accept arguments, call the non-arg version.
@@ -95,24 +118,65 @@ class TypedLambdaPlaceholder final : public PA::IPlaceholder {
         }
     }
 
+    bool evaluateTyped(const PA::IContext* ctx, const std::vector<std::string_view>& args, PA::PlaceholderValue& out)
+        const override {
+        if constexpr (kTyped) {
+            invokeTyped(*static_cast<const Ctx*>(ctx), args, out);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
 private:
+    // lambda 写入 PlaceholderValue 而不是字符串时为类型化占位符
+    static constexpr bool kTyped =
+        std::is_invocable_v<Fn, const Ctx&, PA::PlaceholderValue&>
+        || std::is_invocable_v<Fn, const Ctx&, const std::vector<std::string_view>&, PA::PlaceholderValue&>;
+
+    void invokeTyped(const Ctx& c, const std::vector<std::string_view>& args, PA::PlaceholderValue& out) const {
+        if constexpr (std::is_invocable_v<Fn, const Ctx&, PA::PlaceholderValue&>) {
+            fn_(c, out);
+        } else {
+            fn_(c, args, out);
+        }
+    }
+
+    void writeText(const Ctx& c, const std::vector<std::string_view>& args, std::string& out) const {
+        PA::PlaceholderValue value;
+        invokeTyped(c, args, value);
+        out.clear();
+        value.appendTo(out);
+    }
+
     std::string  token_;
     Fn           fn_;
     unsigned int cacheDuration_;
+    bool         tickStable_;
 };
 
 // 服务器占位符实现（无上下文）
 template <typename Fn>
-class  ServerLambdaPlaceholder final : public PA::IPlaceholder {
+class  ServerLambdaPlaceholder final : public PA::IExtendedPlaceholder {
 public:
-    ServerLambdaPlaceholder(std::string token, Fn fn, unsigned int cacheDuration = 0)
+    ServerLambdaPlaceholder(
+        std::string  token,
+        Fn           fn,
+        unsigned int cacheDuration = 0,
+        uint32_t     cacheFlags    = 0,
+        bool         tickStable    = false
+    )
     : token_(std::move(token)),
       fn_(std::move(fn)),
-      cacheDuration_(cacheDuration) {}
+      cacheDuration_(cacheDuration),
+      cacheFlags_(cacheFlags),
+      tickStable_(tickStable) {}
 
     std::string_view token() const noexcept override { return token_; }
     uint64_t         contextTypeId() const noexcept override { return PA::kServerContextId; }
     unsigned int     getCacheDuration() const noexcept override { return cacheDuration_; }
+    uint32_t         getCacheFlags() const noexcept override { return cacheFlags_; }
+    bool             isTickStable() const noexcept override { return tickStable_; }
 
     void evaluate(const PA::IContext*, std::string& out) const override {
         if constexpr (std::is_invocable_v<Fn, std::string&>) {
@@ -138,6 +202,8 @@ class  ServerLambdaPlaceholder final : public PA::IPlaceholder {
     std::string  token_;
     Fn           fn_;
     unsigned int cacheDuration_;
+    uint32_t     cacheFlags_;
+    bool         tickStable_;
 };
 
 // time 工具
@@ -249,6 +315,103 @@ inline std::tm local_tm(std::time_t t) {
         owner                                                                                                          \
     )
 
+// 带缓存且指定刷新策略（CacheFlags）的服务器级占位符
+#define PA_SERVER_CACHED_FLAGS(svc, owner, token_str, cache_duration, cache_flags, lambda_body)                        \
+    (svc)->registerPlaceholder(                                                                                        \
+        "",                                                                                                            \
+        std::make_shared<ServerLambdaPlaceholder<void (*)(std::string&)>>(                                             \
+            token_str,                                                                                                 \
+            +[](std::string & out) lambda_body,                                                                        \
+            cache_duration,                                                                                            \
+            cache_flags                                                                                                \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
+// 带参数、带缓存且指定刷新策略（CacheFlags）的服务器级占位符
+#define PA_SERVER_WITH_ARGS_CACHED_FLAGS(svc, owner, token_str, cache_duration, cache_flags, lambda_body)              \
+    (svc)->registerPlaceholder(                                                                                        \
+        "",                                                                                                            \
+        std::make_shared<ServerLambdaPlaceholder<void (*)(std::string&, const std::vector<std::string_view>&)>>(       \
+            token_str,                                                                                                 \
+            +[](std::string & out, const std::vector<std::string_view>& args) lambda_body,                             \
+            cache_duration,                                                                                            \
+            cache_flags                                                                                                \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
+// 同一游戏刻内值不变的上下文占位符（无参数、不缓存），EvaluationScope 内按实例只求值一次
+#define PA_SIMPLE_TICK(svc, owner, ctx_type, token_str, lambda_body)                                                   \
+    (svc)->registerPlaceholder(                                                                                        \
+        "",                                                                                                            \
+        std::make_shared<TypedLambdaPlaceholder<ctx_type, void (*)(const ctx_type&, std::string&)>>(                   \
+            token_str,                                                                                                 \
+            +[](const ctx_type& c, std::string& out) lambda_body,                                                      \
+            0,                                                                                                         \
+            true                                                                                                       \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
+// 同一游戏刻内值不变的带参数上下文占位符
+#define PA_WITH_ARGS_TICK(svc, owner, ctx_type, token_str, lambda_body)                                                \
+    (svc)->registerPlaceholder(                                                                                        \
+        "",                                                                                                            \
+        std::make_shared<TypedLambdaPlaceholder<                                                                       \
+            ctx_type,                                                                                                  \
+            void (*)(const ctx_type&, const std::vector<std::string_view>&, std::string&)>>(                           \
+            token_str,                                                                                                 \
+            +[](const ctx_type& c, const std::vector<std::string_view>& args, std::string& out) lambda_body,           \
+            0,                                                                                                         \
+            true                                                                                                       \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
+// 同一游戏刻内值不变的服务器级占位符
+#define PA_SERVER_TICK(svc, owner, token_str, lambda_body)                                                             \
+    (svc)->registerPlaceholder(                                                                                        \
+        "",                                                                                                            \
+        std::make_shared<ServerLambdaPlaceholder<void (*)(std::string&)>>(                                             \
+            token_str,                                                                                                 \
+            +[](std::string & out) lambda_body,                                                                        \
+            0,                                                                                                         \
+            0,                                                                                                         \
+            true                                                                                                       \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
+// 类型化的 tick 稳定上下文占位符：lambda 向 out 写入 PlaceholderValue（如 PlaceholderValue::ofDouble），
+// 格式化阶段直接使用其数值，不再从文本解析
+#define PA_SIMPLE_TICK_TYPED(svc, owner, ctx_type, token_str, lambda_body)                                             \
+    (svc)->registerPlaceholder(                                                                                        \
+        "",                                                                                                            \
+        std::make_shared<TypedLambdaPlaceholder<ctx_type, void (*)(const ctx_type&, PA::PlaceholderValue&)>>(          \
+            token_str,                                                                                                 \
+            +[](const ctx_type& c, PA::PlaceholderValue& out) lambda_body,                                             \
+            0,                                                                                                         \
+            true                                                                                                       \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
+// 类型化的带参数 tick 稳定上下文占位符
+#define PA_WITH_ARGS_TICK_TYPED(svc, owner, ctx_type, token_str, lambda_body)                                          \
+    (svc)->registerPlaceholder(                                                                                        \
+        "",                                                                                                            \
+        std::make_shared<TypedLambdaPlaceholder<                                                                       \
+            ctx_type,                                                                                                  \
+            void (*)(const ctx_type&, const std::vector<std::string_view>&, PA::PlaceholderValue&)>>(                  \
+            token_str,                                                                                                 \
+            +[](const ctx_type& c, const std::vector<std::string_view>& args, PA::PlaceholderValue& out) lambda_body,  \
+            0,                                                                                                         \
+            true                                                                                                       \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
 // ========== 旧版本宏（保持向后兼容） ==========
 #define PA_REGISTER_SIMPLE_PLACEHOLDER(svc, owner, ctx_type, token_str, lambda_body)                                   \
     PA_SIMPLE(svc, owner, ctx_type, token_str, lambda_body)
@@ -295,6 +458,32 @@ inline std::tm local_tm(std::time_t t) {
         owner                                                                                                          \
     )
 
+#define PA_SIMPLE_TICK_P(svc, owner, prefix, ctx_type, token_str, lambda_body)                                         \
+    (svc)->registerPlaceholder(                                                                                        \
+        prefix,                                                                                                        \
+        std::make_shared<TypedLambdaPlaceholder<ctx_type, void (*)(const ctx_type&, std::string&)>>(                   \
+            token_str,                                                                                                 \
+            +[](const ctx_type& c, std::string& out) lambda_body,                                                      \
+            0,                                                                                                         \
+            true                                                                                                       \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
+#define PA_WITH_ARGS_TICK_P(svc, owner, prefix, ctx_type, token_str, lambda_body)                                      \
+    (svc)->registerPlaceholder(                                                                                        \
+        prefix,                                                                                                        \
+        std::make_shared<TypedLambdaPlaceholder<                                                                       \
+            ctx_type,                                                                                                  \
+            void (*)(const ctx_type&, const std::vector<std::string_view>&, std::string&)>>(                           \
+            token_str,                                                                                                 \
+            +[](const ctx_type& c, const std::vector<std::string_view>& args, std::string& out) lambda_body,           \
+            0,                                                                                                         \
+            true                                                                                                       \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
 #define PA_SERVER_P(svc, owner, prefix, token_str, lambda_body)                                                        \
     (svc)->registerPlaceholder(                                                                                        \
         prefix,                                                                                                        \
@@ -316,6 +505,18 @@ inline std::tm local_tm(std::time_t t) {
         owner                                                                                                          \
     )
 
+#define PA_SERVER_CACHED_FLAGS_P(svc, owner, prefix, token_str, cache_duration, cache_flags, lambda_body)              \
+    (svc)->registerPlaceholder(                                                                                        \
+        prefix,                                                                                                        \
+        std::make_shared<ServerLambdaPlaceholder<void (*)(std::string&)>>(                                             \
+            token_str,                                                                                                 \
+            +[](std::string & out) lambda_body,                                                                        \
+            cache_duration,                                                                                            \
+            cache_flags                                                                                                \
+        ),                                                                                                             \
+        owner                                                                                                          \
+    )
+
 #define PA_SERVER_WITH_ARGS_P(svc, owner, prefix, token_str, lambda_body)                                              \
     (svc)->registerPlaceholder(                                                                                        \
         prefix,                                                                                                        \
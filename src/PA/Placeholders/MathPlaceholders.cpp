@@ -0,0 +1,108 @@
+#include "PA/Placeholders/MathPlaceholders.h"
+#include "PA/MathExpression.h"
+#include "PA/ParameterParser.h"
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace PA {
+
+namespace {
+
+// {math:<expr>} / {calc:<expr>}：表达式按原文编译一次并缓存，其中的 {占位符} 作为变量，每次求值时在当前上下文下解析
+class MathPlaceholder final : public IExtendedPlaceholder {
+public:
+    MathPlaceholder(std::string token, const IPlaceholderService* service)
+    : mToken(std::move(token)),
+      mService(service) {}
+
+    std::string_view token() const noexcept override { return mToken; }
+    uint64_t         contextTypeId() const noexcept override { return kServerContextId; }
+
+    void evaluate(const IContext* ctx, std::string& out) const override { evaluateWithArgs(ctx, {}, out); }
+
+    void evaluateWithArgs(const IContext* ctx, const std::vector<std::string_view>& args, std::string& out)
+        const override {
+        PlaceholderValue value;
+        evaluateTyped(ctx, args, value);
+        out.clear();
+        value.appendTo(out);
+    }
+
+    bool evaluateTyped(const IContext* ctx, const std::vector<std::string_view>& args, PlaceholderValue& out)
+        const override {
+        if (args.empty()) {
+            out = PlaceholderValue::ofString(
+                PA_COLOR_RED "Usage: " + std::string(mToken.substr(0, mToken.size() - 1)) + ":<expression>}"
+                PA_COLOR_RESET
+            );
+            return true;
+        }
+
+        // 参数已按顶层逗号切分，这里按原样拼回表达式
+        std::string source(args.front());
+        for (size_t i = 1; i < args.size(); ++i) {
+            source.push_back(',');
+            source.append(args[i]);
+        }
+
+        auto expression = MathExpressionCache::global().acquire(source);
+        if (!expression->ok()) {
+            out = PlaceholderValue::ofString(PA_COLOR_RED "Math error: " + expression->error() + PA_COLOR_RESET);
+            return true;
+        }
+
+        // 变量较少时数值放在栈上，嵌套的 {math} 各自持有自己的缓冲
+        const auto&           variables = expression->variables();
+        std::array<double, 8> inlineValues{};
+        std::vector<double>   heapValues;
+        double*               values = inlineValues.data();
+        if (variables.size() > inlineValues.size()) {
+            heapValues.resize(variables.size());
+            values = heapValues.data();
+        }
+        for (size_t i = 0; i < variables.size(); ++i) {
+            std::string text   = ctx ? mService->replace(variables[i], ctx) : mService->replaceServer(variables[i]);
+            auto        number = ParameterParser::parseNumber(text);
+            if (!number) {
+                // 与表达式编译失败一样给出错误文本，不把 NaN 带入计算
+                out = PlaceholderValue::ofString(
+                    PA_COLOR_RED "Math error: " + variables[i] + " is not a number: '" + text + "'" PA_COLOR_RESET
+                );
+                return true;
+            }
+            values[i] = *number;
+        }
+
+        out = toValue(expression->evaluate({values, variables.size()}));
+        return true;
+    }
+
+private:
+    // 整数结果按整数输出（如 50 而不是 50.000000），其余与 std::to_string 一致
+    static PlaceholderValue toValue(double result) {
+        constexpr double kMaxExactInteger = 9007199254740992.0; // 2^53
+        if (std::isfinite(result) && std::trunc(result) == result && std::fabs(result) <= kMaxExactInteger) {
+            return PlaceholderValue::ofInt(static_cast<int64_t>(result));
+        }
+        return PlaceholderValue::ofDouble(result);
+    }
+
+    std::string                mToken;
+    const IPlaceholderService* mService;
+};
+
+} // namespace
+
+void registerMathPlaceholders(IPlaceholderService* svc) {
+    static int kBuiltinOwnerTag = 0;
+    void*      owner            = &kBuiltinOwnerTag;
+
+    // {math:<expr>} / {calc:<expr>}，例如 {math:{actor_health}/{actor_max_health}*100|precision=1}
+    svc->registerPlaceholder("", std::make_shared<MathPlaceholder>("{math}", svc), owner);
+    svc->registerPlaceholder("", std::make_shared<MathPlaceholder>("{calc}", svc), owner);
+}
+
+} // namespace PA
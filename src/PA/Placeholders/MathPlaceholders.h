@@ -0,0 +1,11 @@
+#pragma once
+
+#include "PA/PlaceholderAPI.h"
+
+namespace PA {
+
+struct IPlaceholderService;
+
+void registerMathPlaceholders(IPlaceholderService* service);
+
+} // namespace PA
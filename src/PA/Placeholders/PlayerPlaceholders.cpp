@@ -101,24 +101,25 @@ void registerPlayerPlaceholders(IPlaceholderService* svc) {
 #endif // _WIN32
 
     // {score}
-    PA_WITH_ARGS(svc, owner, ActorContext, "{score}", {
+    PA_WITH_ARGS_TICK_TYPED(svc, owner, ActorContext, "{score}", {
         if (c.actor && !args.empty()) {
             std::string score_name(args[0]);
             Scoreboard& scoreboard = ll::service::getLevel()->getScoreboard();
             Objective*  obj        = scoreboard.getObjective(score_name);
             if (!obj) {
-                out = "0";
+                out = PlaceholderValue::ofInt(0);
                 return;
             }
             const ScoreboardId& id = scoreboard.getScoreboardId(*c.actor);
             if (id.mRawID == ScoreboardId::INVALID().mRawID) {
                 // 如果玩家没有记分板ID，则分数默认为0
-                out = "0";
+                out = PlaceholderValue::ofInt(0);
                 return;
             }
-            out = std::to_string(obj->getPlayerScore(id).mValue);
+            out = PlaceholderValue::ofInt(obj->getPlayerScore(id).mValue);
         } else {
-            out = PA_COLOR_RED "Usage: {score:objective_name}" PA_COLOR_RESET; // 如果没有提供参数，返回使用说明
+            // 如果没有提供参数，返回使用说明
+            out = PlaceholderValue::ofString(PA_COLOR_RED "Usage: {score:objective_name}" PA_COLOR_RESET);
         }
     });
 
@@ -195,12 +196,12 @@ void registerPlayerPlaceholders(IPlaceholderService* svc) {
     });
 
     // {player_hunger}
-    PA_SIMPLE(svc, owner, PlayerContext, "{player_hunger}", {
-        out.clear();
+    PA_SIMPLE_TICK_TYPED(svc, owner, PlayerContext, "{player_hunger}", {
+        out = PlaceholderValue::ofString("");
         if (c.player) {
             auto attrRef = c.player->getAttribute(Player::HUNGER());
             if (attrRef.mPtr) {
-                out = std::to_string(attrRef.mPtr->mCurrentValue);
+                out = PlaceholderValue::ofDouble(attrRef.mPtr->mCurrentValue);
             }
         }
     });
@@ -217,12 +218,12 @@ void registerPlayerPlaceholders(IPlaceholderService* svc) {
     });
 
     // {player_saturation}
-    PA_SIMPLE(svc, owner, PlayerContext, "{player_saturation}", {
-        out.clear();
+    PA_SIMPLE_TICK_TYPED(svc, owner, PlayerContext, "{player_saturation}", {
+        out = PlaceholderValue::ofString("");
         if (c.player) {
             auto attrRef = c.player->getAttribute(Player::SATURATION());
             if (attrRef.mPtr) {
-                out = std::to_string(attrRef.mPtr->mCurrentValue);
+                out = PlaceholderValue::ofDouble(attrRef.mPtr->mCurrentValue);
             }
         }
     });
@@ -36,7 +36,8 @@ void registerServerPlaceholders(IPlaceholderService* svc) {
 
     // {total_entities} - 允许通过参数选择是否排除掉落物，或指定只计算特定类型
     // 用法: {total_entities:type=minecraft:zombie,type=minecraft:skeleton,exclude_drops}
-    PA_SERVER_WITH_ARGS(svc, owner, "{total_entities}", {
+    // 遍历全部实体开销较大：缓存 5 秒，并在主线程上提前刷新，过期时先返回旧值，渲染不会被遍历阻塞
+    PA_SERVER_WITH_ARGS_CACHED_FLAGS(svc, owner, "{total_entities}", 5, kCacheRefreshAhead | kCacheStaleWhileRevalidate, {
         auto level = ll::service::getLevel();
         if (!level) {
             out = "0";
@@ -124,8 +125,8 @@ void registerServerPlaceholders(IPlaceholderService* svc) {
         out           = settings ? std::to_string(settings->mServerPortv6) : "0";
     });
 
-    // {server_mod_count} - 缓存 1 分钟
-    PA_SERVER_CACHED(svc, owner, "{server_mod_count}", 60, {
+    // {server_mod_count} - 缓存 1 分钟，提前刷新，过期时先返回旧值
+    PA_SERVER_CACHED_FLAGS(svc, owner, "{server_mod_count}", 60, kCacheRefreshAhead | kCacheStaleWhileRevalidate, {
         size_t totalModCount = 0;
         for (auto& manager : ll::mod::ModManagerRegistry::getInstance().managers()) {
             totalModCount += manager.getModCount();
@@ -0,0 +1,148 @@
+// src/PA/ShardedLruCache.h
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PA {
+
+// LRU 缓存统计
+struct LruCacheStats {
+    uint64_t hits{};
+    uint64_t misses{};
+    uint64_t evictions{};
+    uint64_t size{};
+    uint64_t capacity{};
+};
+
+/**
+ * @brief 分片 LRU 缓存
+ * 按 key 的哈希分片，每个分片独立加锁，降低多线程渲染时的锁竞争。
+ * 容量按分片均分；Value 以拷贝方式取出，建议存放 shared_ptr 等廉价可拷贝类型。
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+class ShardedLruCache {
+public:
+    explicit ShardedLruCache(size_t capacity, size_t shardCount = 16)
+    : mShards(std::max<size_t>(shardCount, 1)) {
+        setCapacity(capacity);
+    }
+
+    ShardedLruCache(const ShardedLruCache&)            = delete;
+    ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+    // 查找并刷新最近使用顺序
+    std::optional<Value> get(const Key& key) {
+        auto&                       shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto                        it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            mMisses.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        shard.order.splice(shard.order.begin(), shard.order, it->second);
+        mHits.fetch_add(1, std::memory_order_relaxed);
+        return it->second->second;
+    }
+
+    // 插入或覆盖，超出分片容量时淘汰最久未使用的条目
+    void put(const Key& key, Value value) {
+        auto&                       shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.capacity == 0) {
+            return;
+        }
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            it->second->second = std::move(value);
+            shard.order.splice(shard.order.begin(), shard.order, it->second);
+            return;
+        }
+        shard.order.emplace_front(key, std::move(value));
+        shard.index.emplace(key, shard.order.begin());
+        evictOverflow(shard);
+    }
+
+    bool erase(const Key& key) {
+        auto&                       shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto                        it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return false;
+        }
+        shard.order.erase(it->second);
+        shard.index.erase(it);
+        return true;
+    }
+
+    // 调整总容量（0 表示禁用），超出部分立即淘汰
+    void setCapacity(size_t capacity) {
+        mCapacity.store(capacity, std::memory_order_relaxed);
+        const size_t perShard = capacity == 0 ? 0 : std::max<size_t>(1, (capacity + mShards.size() - 1) / mShards.size());
+        for (auto& shard : mShards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.capacity = perShard;
+            evictOverflow(shard);
+        }
+    }
+
+    size_t capacity() const { return mCapacity.load(std::memory_order_relaxed); }
+
+    void clear() {
+        for (auto& shard : mShards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.index.clear();
+            shard.order.clear();
+        }
+    }
+
+    LruCacheStats stats() const {
+        LruCacheStats result;
+        result.hits      = mHits.load(std::memory_order_relaxed);
+        result.misses    = mMisses.load(std::memory_order_relaxed);
+        result.evictions = mEvictions.load(std::memory_order_relaxed);
+        result.capacity  = mCapacity.load(std::memory_order_relaxed);
+        for (auto& shard : mShards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            result.size += shard.index.size();
+        }
+        return result;
+    }
+
+private:
+    using Node = std::pair<Key, Value>;
+
+    struct Shard {
+        mutable std::mutex                                                  mutex;
+        std::list<Node>                                                     order; // 头部为最近使用
+        std::unordered_map<Key, typename std::list<Node>::iterator, Hash, Equal> index;
+        size_t                                                              capacity{};
+    };
+
+    Shard& shardFor(const Key& key) { return mShards[Hash{}(key) % mShards.size()]; }
+
+    void evictOverflow(Shard& shard) {
+        while (shard.index.size() > shard.capacity) {
+            shard.index.erase(shard.order.back().first);
+            shard.order.pop_back();
+            mEvictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<Shard>    mShards;
+    std::atomic<size_t>   mCapacity{0};
+    std::atomic<uint64_t> mHits{0};
+    std::atomic<uint64_t> mMisses{0};
+    std::atomic<uint64_t> mEvictions{0};
+};
+
+} // namespace PA
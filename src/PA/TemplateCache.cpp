@@ -0,0 +1,59 @@
+// src/PA/TemplateCache.cpp
+#include "PA/TemplateCache.h"
+#include "PA/CompiledTemplate.h"
+#include "PA/PlaceholderProcessor.h"
+
+namespace PA {
+
+TemplateCache::TemplateCache(size_t capacity) : mCache(capacity) {}
+
+bool TemplateCache::admit(uint64_t tag) {
+    auto& slot = mDoorkeeper[tag & (kDoorkeeperSlots - 1)];
+    if (slot.load(std::memory_order_relaxed) == tag) {
+        return true;
+    }
+    slot.store(tag, std::memory_order_relaxed);
+    return false;
+}
+
+CompiledTemplateHandle TemplateCache::acquire(std::string_view text, uint64_t registryVersion) {
+    if (mCache.capacity() == 0 || text.length() > kMaxTemplateLength
+        || text.find_first_of("%{") == std::string_view::npos) {
+        return nullptr;
+    }
+
+    Key key{fnv1a64_constexpr(text.data(), text.size()), registryVersion};
+    if (auto cached = mCache.get(key)) {
+        // 哈希碰撞时按未命中处理，新模板会覆盖旧条目
+        if (*cached && (*cached)->source == text) {
+            return *cached;
+        }
+    }
+
+    if (!admit(key.textHash ^ (registryVersion * 0x9E3779B97F4A7C15ull))) {
+        mBypassed.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto compiled = PlaceholderProcessor::compile(text);
+    mCache.put(key, compiled);
+    return compiled;
+}
+
+void TemplateCache::setCapacity(size_t capacity) { mCache.setCapacity(capacity); }
+
+void TemplateCache::clear() { mCache.clear(); }
+
+TemplateCacheStats TemplateCache::stats() const {
+    auto               lru = mCache.stats();
+    TemplateCacheStats result;
+    result.hits      = lru.hits;
+    result.misses    = lru.misses;
+    result.evictions = lru.evictions;
+    result.bypassed  = mBypassed.load(std::memory_order_relaxed);
+    result.size      = lru.size;
+    result.capacity  = lru.capacity;
+    return result;
+}
+
+} // namespace PA
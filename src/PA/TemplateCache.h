@@ -0,0 +1,57 @@
+// src/PA/TemplateCache.h
+#pragma once
+
+#include "PA/PlaceholderAPI.h"
+#include "PA/ShardedLruCache.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace PA {
+
+/**
+ * @brief replace()/replaceServer() 背后的预编译模板缓存
+ * key 为 {模板文本哈希, 注册表快照版本}，命中后直接渲染，跳过扫描、token 查找与参数解析。
+ * 只出现过一次的文本（例如普通聊天内容）不会进入缓存：首次出现仅登记哈希，第二次出现才编译入缓存。
+ */
+class TemplateCache {
+public:
+    explicit TemplateCache(size_t capacity);
+
+    // 获取（必要时编译）模板；返回 nullptr 表示不值得缓存，调用方应直接走一次性处理
+    CompiledTemplateHandle acquire(std::string_view text, uint64_t registryVersion);
+
+    void setCapacity(size_t capacity);
+    void clear();
+
+    TemplateCacheStats stats() const;
+
+private:
+    struct Key {
+        uint64_t textHash{};
+        uint64_t registryVersion{};
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept {
+            return static_cast<size_t>(key.textHash ^ (key.registryVersion * 0x9E3779B97F4A7C15ull));
+        }
+    };
+
+    // 超过该长度的文本不缓存，避免大块 JSON/表单正文占满缓存
+    static constexpr size_t kMaxTemplateLength = 8192;
+    // 准入过滤器槽位数（必须为 2 的幂）
+    static constexpr size_t kDoorkeeperSlots = 4096;
+
+    bool admit(uint64_t tag);
+
+    ShardedLruCache<Key, CompiledTemplateHandle, KeyHash> mCache;
+    std::array<std::atomic<uint64_t>, kDoorkeeperSlots>   mDoorkeeper{};
+    std::atomic<uint64_t>                                 mBypassed{0};
+};
+
+} // namespace PA
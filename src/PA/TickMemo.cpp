@@ -0,0 +1,119 @@
+// src/PA/TickMemo.cpp
+#include "PA/TickMemo.h"
+#include "PA/PlaceholderCacheStore.h"
+
+#include <unordered_map>
+
+namespace PA {
+
+namespace {
+
+// 最外层作用域开始时条目数超过该值则整体清空，避免一次性的上下文实例在线程上长期累积
+constexpr size_t kRetainLimit = 4096;
+
+struct Key {
+    const IPlaceholder* placeholder{};
+    uint64_t            instanceId{};
+    std::string         args;
+    std::string         instanceKey;
+};
+
+struct KeyView {
+    const IPlaceholder* placeholder{};
+    uint64_t            instanceId{};
+    std::string_view    args;
+    std::string_view    instanceKey;
+};
+
+struct KeyHash {
+    using is_transparent = void;
+    size_t operator()(const Key& key) const noexcept { return hash(key.placeholder, key.instanceId, key.args); }
+    size_t operator()(const KeyView& key) const noexcept { return hash(key.placeholder, key.instanceId, key.args); }
+
+    static size_t hash(const IPlaceholder* placeholder, uint64_t instanceId, std::string_view args) noexcept {
+        const uint64_t argsHash = args.empty() ? 0 : std::hash<std::string_view>{}(args);
+        const uint64_t h        = PlaceholderCacheKey::combine(instanceId, argsHash);
+        return static_cast<size_t>(h ^ (reinterpret_cast<uintptr_t>(placeholder) * 0x9e3779b97f4a7c15ull));
+    }
+};
+
+struct KeyEqual {
+    using is_transparent = void;
+    template <typename A, typename B>
+    bool operator()(const A& a, const B& b) const noexcept {
+        return a.placeholder == b.placeholder && a.instanceId == b.instanceId
+            && std::string_view(a.args) == std::string_view(b.args)
+            && std::string_view(a.instanceKey) == std::string_view(b.instanceKey);
+    }
+};
+
+struct Entry {
+    uint64_t    generation{};
+    std::string value;
+};
+
+struct State {
+    uint32_t                                           depth{};
+    uint64_t                                           generation{1};
+    std::unordered_map<Key, Entry, KeyHash, KeyEqual> values;
+};
+
+State& localState() {
+    thread_local State state;
+    return state;
+}
+
+} // namespace
+
+void TickMemo::enter() {
+    State& state = localState();
+    if (state.depth++ == 0 && state.values.size() > kRetainLimit) {
+        state.values.clear();
+    }
+}
+
+void TickMemo::exit() {
+    State& state = localState();
+    if (state.depth > 0 && --state.depth == 0) {
+        ++state.generation;
+    }
+}
+
+bool TickMemo::active() noexcept { return localState().depth > 0; }
+
+const std::string*
+TickMemo::find(const IPlaceholder* placeholder, const ContextInstanceKey& instance, std::string_view args) {
+    State& state = localState();
+    if (state.depth == 0) {
+        return nullptr;
+    }
+    auto it = state.values.find(KeyView{placeholder, instance.id(), args, instance.exactKey()});
+    if (it == state.values.end() || it->second.generation != state.generation) {
+        return nullptr;
+    }
+    return &it->second.value;
+}
+
+void TickMemo::store(
+    const IPlaceholder*       placeholder,
+    const ContextInstanceKey& instance,
+    std::string_view          args,
+    const std::string&        value
+) {
+    State& state = localState();
+    if (state.depth == 0) {
+        return;
+    }
+    auto it = state.values.find(KeyView{placeholder, instance.id(), args, instance.exactKey()});
+    if (it == state.values.end()) {
+        state.values.emplace(
+            Key{placeholder, instance.id(), std::string(args), std::string(instance.exactKey())},
+            Entry{state.generation, value}
+        );
+        return;
+    }
+    it->second.generation = state.generation;
+    it->second.value      = value;
+}
+
+} // namespace PA
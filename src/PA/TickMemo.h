@@ -0,0 +1,39 @@
+// src/PA/TickMemo.h
+#pragma once
+
+#include "PA/ContextInstance.h"
+#include "PA/PlaceholderAPI.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace PA {
+
+/**
+ * @brief EvaluationScope 背后的线程本地求值备忘
+ * 作用域内，未缓存且 IExtendedPlaceholder::isTickStable() 的占位符按 {占位符, 上下文实例, 求值参数} 只求值一次，
+ * 同一作用域中渲染的所有模板看到同一个值。
+ * 作用域按线程计数、可嵌套；最外层退出时只递增代数，旧条目随即全部失效（O(1)），之后的写入原地复用它们的槽位。
+ */
+class TickMemo {
+public:
+    static void enter();
+    static void exit();
+
+    // 当前线程是否处于作用域内
+    static bool active() noexcept;
+
+    // 查找本次作用域内的值；不在作用域内时总是返回 nullptr
+    static const std::string*
+    find(const IPlaceholder* placeholder, const ContextInstanceKey& instance, std::string_view args);
+
+    static void store(
+        const IPlaceholder*       placeholder,
+        const ContextInstanceKey& instance,
+        std::string_view          args,
+        const std::string&        value
+    );
+};
+
+} // namespace PA
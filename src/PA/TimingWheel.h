@@ -0,0 +1,117 @@
+// src/PA/TimingWheel.h
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace PA {
+
+/**
+ * @brief 分层时间轮
+ * 4 层、每层 64 个槽：第 0 层按 tick 精度覆盖最近 64 个 tick，每往上一层跨度扩大 64 倍，
+ * 超出最高层跨度的条目放入溢出表。插入 O(1)；推进时只处理到期槽位，上层槽位在低位回绕时整体下沉一次。
+ * 条目不支持取消，调用方在触发时自行校验是否仍然有效。非线程安全，由调用方加锁。
+ */
+template <typename T>
+class TimingWheel {
+public:
+    using Clock     = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    explicit TimingWheel(Clock::duration tick, TimePoint start = Clock::now()) : mTick(tick), mStart(start) {}
+
+    Clock::duration tick() const noexcept { return mTick; }
+
+    // 当前 tick 结束的时刻：早于该时刻调用 advance() 不会有条目到期
+    TimePoint nextTickAt() const noexcept { return mStart + mTick * static_cast<int64_t>(mCurrentTick + 1); }
+
+    size_t size() const noexcept { return mSize; }
+
+    // 条目在不早于 deadline 的第一个 tick 触发；deadline 已过去的条目在下一个 tick 触发
+    void schedule(TimePoint deadline, T item) {
+        uint64_t due = ticksAt(deadline + mTick - Clock::duration(1));
+        if (due <= mCurrentTick) {
+            due = mCurrentTick + 1;
+        }
+        place(Slotted{due, std::move(item)});
+        ++mSize;
+    }
+
+    // 推进到 now，把到期条目追加到 expired
+    void advance(TimePoint now, std::vector<T>& expired) {
+        const uint64_t target = ticksAt(now);
+        while (mCurrentTick < target) {
+            ++mCurrentTick;
+            cascade();
+
+            auto& slot = mLevels[0][mCurrentTick & kSlotMask];
+            for (Slotted& entry : slot) {
+                expired.push_back(std::move(entry.item));
+            }
+            mSize -= slot.size();
+            slot.clear();
+        }
+    }
+
+private:
+    static constexpr unsigned kLevels   = 4;
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr uint64_t kSlots    = uint64_t{1} << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+
+    struct Slotted {
+        uint64_t due{};
+        T        item;
+    };
+
+    uint64_t ticksAt(TimePoint time) const {
+        if (time <= mStart) {
+            return 0;
+        }
+        return static_cast<uint64_t>((time - mStart) / mTick);
+    }
+
+    void place(Slotted&& entry) {
+        const uint64_t delta = entry.due - mCurrentTick;
+        for (unsigned level = 0; level < kLevels; ++level) {
+            if (delta < (kSlots << (kSlotBits * level))) {
+                mLevels[level][(entry.due >> (kSlotBits * level)) & kSlotMask].push_back(std::move(entry));
+                return;
+            }
+        }
+        mOverflow.push_back(std::move(entry));
+    }
+
+    // 第 level 层的低位全部回绕为 0 时，把该层当前槽位的条目按剩余时间重新放入更低的层；从高层往低层处理
+    void cascade() {
+        if ((mCurrentTick & ((uint64_t{1} << (kSlotBits * (kLevels - 1))) - 1)) == 0) {
+            std::vector<Slotted> overflow;
+            overflow.swap(mOverflow);
+            for (Slotted& entry : overflow) {
+                place(std::move(entry));
+            }
+        }
+        for (unsigned level = kLevels - 1; level > 0; --level) {
+            if ((mCurrentTick & ((uint64_t{1} << (kSlotBits * level)) - 1)) != 0) {
+                continue;
+            }
+            std::vector<Slotted> slot;
+            slot.swap(mLevels[level][(mCurrentTick >> (kSlotBits * level)) & kSlotMask]);
+            for (Slotted& entry : slot) {
+                place(std::move(entry));
+            }
+        }
+    }
+
+    Clock::duration                                               mTick;
+    TimePoint                                                     mStart;
+    uint64_t                                                      mCurrentTick{};
+    size_t                                                        mSize{};
+    std::array<std::array<std::vector<Slotted>, kSlots>, kLevels> mLevels;
+    std::vector<Slotted>                                          mOverflow;
+};
+
+} // namespace PA
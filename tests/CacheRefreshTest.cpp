@@ -0,0 +1,97 @@
+// tests/CacheRefreshTest.cpp
+#include "SelfTest.h"
+#include "PA/PlaceholderCacheStore.h"
+#include "PA/PlaceholderProcessor.h"
+#include "PA/PlaceholderRegistry.h"
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PA::SelfTest {
+
+namespace {
+
+// 模拟外部插件定义的上下文：实例 id 取自实例键的哈希
+struct HashedContext : public IContext {
+    static constexpr uint64_t kTypeId = TypeId("ctx:SelfTestRefresh");
+    std::string               key;
+
+    explicit HashedContext(std::string instanceKey) : key(std::move(instanceKey)) {}
+
+    uint64_t typeId() const noexcept override { return kTypeId; }
+
+    const std::vector<uint64_t>& getInheritedTypeIds() const noexcept override {
+        static const std::vector<uint64_t> ids = {kTypeId};
+        return ids;
+    }
+
+    std::string getContextInstanceKey() const noexcept override { return key; }
+};
+
+// 与 {total_entities} 相同的注册方式：服务器级、带参数、提前刷新并在过期后返回旧值
+// 输出收到的参数与求值序号
+class RefreshProbePlaceholder final : public IExtendedPlaceholder {
+public:
+    std::string_view token() const noexcept override { return "{refresh_probe}"; }
+    uint64_t         contextTypeId() const noexcept override { return kServerContextId; }
+    unsigned int     getCacheDuration() const noexcept override { return 1; }
+    uint32_t         getCacheFlags() const noexcept override { return kCacheRefreshAhead | kCacheStaleWhileRevalidate; }
+    void             evaluate(const IContext*, std::string& out) const override { out = fmt::format("-#{}", ++mCalls); }
+
+    void evaluateWithArgs(const IContext*, const std::vector<std::string_view>& args, std::string& out) const override {
+        out = fmt::format("{}#{}", fmt::join(args, ","), ++mCalls);
+    }
+
+private:
+    mutable std::atomic<int> mCalls{0};
+};
+
+} // namespace
+
+// 经哈希实例 id 的上下文渲染服务器级刷新类缓存值：所有实例共用一份，后台刷新按原始参数重新求值
+PA_SELF_TEST_CASE(CacheRefreshThroughHashedInstance) {
+    static int                         owner = 0;
+    std::mutex                         tasksMutex;
+    std::vector<std::function<void()>> tasks;
+    PlaceholderRegistry                registry;
+    registry.registerCachedPlaceholder("", std::make_shared<RefreshProbePlaceholder>(), &owner, 1);
+    registry.getCacheStore().setExecutor([&](std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        tasks.push_back(std::move(task));
+    });
+
+    HashedContext     alpha("alpha");
+    HashedContext     beta("beta");
+    const std::string text = "{refresh_probe:type=zombie,exclude_drops}";
+    t.check(PlaceholderProcessor::process(text, &alpha, registry) == "type=zombie,exclude_drops#1", "first render");
+    t.check(PlaceholderProcessor::process(text, &beta, registry) == "type=zombie,exclude_drops#1", "shared value");
+
+    // 过期后的第一次读取返回旧值并发起唯一一次刷新
+    std::this_thread::sleep_for(std::chrono::milliseconds(1200));
+    t.check(PlaceholderProcessor::process(text, &alpha, registry) == "type=zombie,exclude_drops#1", "stale render");
+
+    std::vector<std::function<void()>> pending;
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        pending.swap(tasks);
+    }
+    t.check(pending.size() == 1, fmt::format("expected one refresh, got {}", pending.size()));
+    for (auto& task : pending) {
+        task();
+    }
+
+    auto tpl = PlaceholderProcessor::compile(text);
+    t.check(PlaceholderProcessor::render(*tpl, &beta, registry) == "type=zombie,exclude_drops#2", "refreshed value");
+    registry.getCacheStore().setExecutor({});
+}
+
+} // namespace PA::SelfTest
@@ -0,0 +1,141 @@
+// tests/CacheStoreContentionTest.cpp
+#include "SelfTest.h"
+#include "PA/PlaceholderCacheStore.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PA::SelfTest {
+
+namespace {
+
+constexpr size_t kKeyCount  = 4096;
+constexpr size_t kInstances = 16;
+
+// 值的前缀记录 key 与版本，其后填充由 key 决定的字符，长度随版本变化；读到的值若混入其他 key 或其他版本即可发现
+std::string makeValue(size_t key, uint64_t version) {
+    std::string value = fmt::format("{}:{}:", key, version);
+    value.append(static_cast<size_t>(version * 37 % 1024), static_cast<char>('a' + key % 26));
+    return value;
+}
+
+bool checkValue(size_t key, const std::string& value) {
+    const size_t keyEnd     = value.find(':');
+    const size_t versionEnd = keyEnd == std::string::npos ? keyEnd : value.find(':', keyEnd + 1);
+    if (versionEnd == std::string::npos || value.compare(0, keyEnd, std::to_string(key)) != 0) {
+        return false;
+    }
+    const uint64_t version = std::stoull(value.substr(keyEnd + 1, versionEnd - keyEnd - 1));
+    const size_t   fill    = value.size() - versionEnd - 1;
+    const char     filler  = static_cast<char>('a' + key % 26);
+    return fill == version * 37 % 1024
+        && std::all_of(value.begin() + static_cast<std::ptrdiff_t>(versionEnd + 1), value.end(), [&](char c) {
+               return c == filler;
+           });
+}
+
+PlaceholderCacheKey keyOf(size_t key, const std::vector<std::string>& args) {
+    return {key % kInstances + 1, args[key]};
+}
+
+} // namespace
+
+/**
+ * 多个读者与写者同时访问同一组 key：写者不断以新 blob 替换桶链上的旧值、触发淘汰与实例失效，
+ * 读者无锁读取并校验每个值的完整性，同时报告有无写者时的读取吞吐量。
+ * 条目上限小于 key 数，桶链的摘除与 EpochDomain 回收、有损读缓冲的回放都会在读者活跃时发生
+ */
+PA_SELF_TEST_CASE(CacheStoreContention) {
+    constexpr auto kDuration = std::chrono::milliseconds(200);
+
+    std::vector<std::string> args;
+    args.reserve(kKeyCount);
+    for (size_t key = 0; key < kKeyCount; ++key) {
+        args.push_back(fmt::format("arg{}", key));
+    }
+
+    const unsigned maxThreads = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+    for (unsigned writers : {0u, 2u}) {
+        for (unsigned readers = 1; readers <= maxThreads; readers *= 2) {
+            PlaceholderCacheStore store(kKeyCount / 4, size_t{4} << 20, 0);
+            const uint64_t        id = store.allocate(60);
+            for (size_t key = 0; key < kKeyCount; ++key) {
+                store.put(id, keyOf(key, args), makeValue(key, 0));
+            }
+
+            std::atomic<bool>     stop{false};
+            std::atomic<uint64_t> reads{0};
+            std::atomic<uint64_t> hits{0};
+            std::atomic<uint64_t> writes{0};
+            std::atomic<uint64_t> corrupt{0};
+
+            std::vector<std::thread> threads;
+            for (unsigned i = 0; i < readers; ++i) {
+                threads.emplace_back([&, seed = i] {
+                    std::string value;
+                    uint64_t    localReads = 0;
+                    uint64_t    localHits  = 0;
+                    size_t      key        = seed * 977;
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        key = (key + 7919) % kKeyCount;
+                        if (store.get(id, keyOf(key, args), value)) {
+                            ++localHits;
+                            if (!checkValue(key, value)) {
+                                corrupt.fetch_add(1, std::memory_order_relaxed);
+                            }
+                        }
+                        ++localReads;
+                    }
+                    reads.fetch_add(localReads);
+                    hits.fetch_add(localHits);
+                });
+            }
+            for (unsigned i = 0; i < writers; ++i) {
+                threads.emplace_back([&, seed = i] {
+                    uint64_t version = 1;
+                    size_t   key     = seed * 131;
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        key = (key + 104729) % kKeyCount;
+                        store.put(id, keyOf(key, args), makeValue(key, version++));
+                        if (version % 4096 == 0) {
+                            store.invalidateInstance(key % kInstances + 1);
+                        }
+                    }
+                    writes.fetch_add(version - 1);
+                });
+            }
+
+            std::this_thread::sleep_for(kDuration);
+            stop.store(true);
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            const double          seconds = std::chrono::duration<double>(kDuration).count();
+            const ValueCacheStats stats   = store.stats();
+            t.report(fmt::format(
+                "{} writer(s), {} reader(s): {:10.0f} reads/s ({:9.0f} per reader), hit {:5.1f}%, "
+                "{:9.0f} writes/s, {} local hit(s), {} eviction(s)",
+                writers,
+                readers,
+                static_cast<double>(reads.load()) / seconds,
+                static_cast<double>(reads.load()) / seconds / readers,
+                reads.load() ? 100.0 * static_cast<double>(hits.load()) / static_cast<double>(reads.load()) : 0.0,
+                static_cast<double>(writes.load()) / seconds,
+                stats.localHits,
+                stats.evictions
+            ));
+            t.check(corrupt.load() == 0, fmt::format("{} read(s) returned a torn or foreign value", corrupt.load()));
+            t.check(stats.size <= kKeyCount / 4, "entry limit exceeded under contention");
+            store.release(id);
+        }
+    }
+}
+
+} // namespace PA::SelfTest
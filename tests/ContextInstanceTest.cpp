@@ -0,0 +1,112 @@
+// tests/ContextInstanceTest.cpp
+#include "SelfTest.h"
+#include "PA/ContextInstance.h"
+#include "PA/PlaceholderCacheStore.h"
+#include "PA/PlaceholderProcessor.h"
+#include "PA/PlaceholderRegistry.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <string>
+
+namespace PA::SelfTest {
+
+namespace {
+
+// 模拟外部插件定义的上下文：只实现基线虚函数
+struct KeyedContext : public IContext {
+    static constexpr uint64_t kTypeId = TypeId("ctx:SelfTestKeyed");
+    std::string               key;
+
+    explicit KeyedContext(std::string instanceKey) : key(std::move(instanceKey)) {}
+
+    uint64_t typeId() const noexcept override { return kTypeId; }
+
+    const std::vector<uint64_t>& getInheritedTypeIds() const noexcept override {
+        static const std::vector<uint64_t> ids = {kTypeId};
+        return ids;
+    }
+
+    std::string getContextInstanceKey() const noexcept override { return key; }
+};
+
+// 输出上下文的实例键，用于检查缓存值是否串到其他实例
+class EchoKeyPlaceholder final : public IPlaceholder {
+public:
+    std::string_view token() const noexcept override { return "{echo_key}"; }
+    uint64_t         contextTypeId() const noexcept override { return KeyedContext::kTypeId; }
+    unsigned int     getCacheDuration() const noexcept override { return 60; }
+    void             evaluate(const IContext* ctx, std::string& out) const override {
+        out = static_cast<const KeyedContext*>(ctx)->key;
+    }
+};
+
+} // namespace
+
+PA_SELF_TEST_CASE(ContextInstanceIds) {
+    auto* object = reinterpret_cast<Player*>(uintptr_t{0x10000});
+    auto  player = PlayerContext::from(object);
+    auto  mob    = MobContext::from(reinterpret_cast<Mob*>(object));
+    t.check(player.instanceId() == 0x10000, "player id must be its address");
+    t.check(mob.instanceId() == player.instanceId(), "mob and player views must share one id");
+    t.check(PlayerContext().instanceId() == 0, "empty player context must map to 0");
+
+    KeyedContext keyed("alpha");
+    t.check((keyed.instanceId() & kHashedInstanceIdBit) != 0, "foreign context id must be marked as hashed");
+    t.check(KeyedContext("").instanceId() == 0, "empty instance key must map to 0");
+
+    t.check(ContextInstanceKey(&player).exactKey().empty(), "builtin contexts must not carry an instance key");
+    t.check(ContextInstanceKey(&keyed).exactKey() == "alpha", "hashed ids must keep the exact instance key");
+}
+
+// 哈希相同的两个自定义实例：key 中的实例键原文仍能区分它们，参数保持原样
+PA_SELF_TEST_CASE(ContextInstanceCollision) {
+    KeyedContext       alpha("alpha");
+    KeyedContext       beta("beta");
+    ContextInstanceKey alphaKey(&alpha);
+    ContextInstanceKey betaKey(&beta);
+
+    PlaceholderCacheStore store;
+    const uint64_t        id       = store.allocate(60);
+    const uint64_t        sharedId = alphaKey.id(); // 模拟碰撞：两个实例使用同一 id
+    store.put(id, {sharedId, "arg", alphaKey.exactKey()}, "alpha-value");
+    store.put(id, {sharedId, "arg", betaKey.exactKey()}, "beta-value");
+
+    std::string value;
+    t.check(store.get(id, {sharedId, "arg", alphaKey.exactKey()}, value) && value == "alpha-value", "alpha lookup");
+    t.check(store.get(id, {sharedId, "arg", betaKey.exactKey()}, value) && value == "beta-value", "beta lookup");
+    t.check(!store.get(id, {sharedId, "arg"}, value), "a key without the instance key must not match");
+
+    static int          owner = 0;
+    PlaceholderRegistry registry;
+    registry.registerCachedPlaceholder("", std::make_shared<EchoKeyPlaceholder>(), &owner, 60);
+    for (int round = 0; round < 2; ++round) {
+        t.check(PlaceholderProcessor::process("{echo_key}", &alpha, registry) == "alpha", "alpha render");
+        t.check(PlaceholderProcessor::process("{echo_key}", &beta, registry) == "beta", "beta render");
+    }
+}
+
+// 服务器级值不进入实例索引：按 0 或其他实例失效都不能移除它们
+PA_SELF_TEST_CASE(ContextInstanceInvalidate) {
+    PlaceholderCacheStore store;
+    const uint64_t        id       = store.allocate(60);
+    const uint64_t        instance = 0x20000;
+    store.put(id, {0, "server"}, "server-value");
+    store.put(id, {instance, "a"}, "instance-a");
+    store.put(id, {instance, "b"}, "instance-b");
+
+    std::string value;
+    t.check(store.invalidateInstance(0) == 0, "instance 0 must not remove anything");
+    t.check(store.get(id, {0, "server"}, value) && value == "server-value", "server value after invalidate(0)");
+
+    t.check(store.invalidateInstance(instance) == 2, "both values of the instance must be removed");
+    t.check(!store.get(id, {instance, "a"}, value), "instance value still cached");
+    t.check(store.get(id, {0, "server"}, value) && value == "server-value", "server value after instance removal");
+
+    store.put(id, {instance, "c"}, "instance-c");
+    store.release(id);
+    t.check(store.invalidateInstance(instance) == 0, "released placeholder must leave no index entries");
+}
+
+} // namespace PA::SelfTest
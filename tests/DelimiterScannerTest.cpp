@@ -0,0 +1,118 @@
+// tests/DelimiterScannerTest.cpp
+#include "SelfTest.h"
+#include "PA/DelimiterScanner.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace PA::SelfTest {
+
+namespace {
+
+using DelimiterScanner::SimdLevel;
+
+constexpr SimdLevel kLevels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2};
+
+// 逐字节的参考实现，与各指令集版本对拍
+bool referenceScan(std::string_view text, std::vector<size_t>& out) {
+    bool hasStart = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (c == '{' || c == '}' || c == '%' || c == '\\') {
+            out.push_back(i);
+            hasStart = hasStart || c == '{' || c == '%';
+        }
+    }
+    return hasStart;
+}
+
+// density 为结构字符占比（0~1）；其余字符取自普通 ASCII 与多字节 UTF-8 片段
+std::string randomText(std::mt19937_64& rng, size_t length, double density) {
+    static constexpr char             kStructural[] = {'{', '}', '%', '\\'};
+    static constexpr std::string_view kPlain        = "abcXYZ019 _:|=,.-\xC2\xA7\xE4\xB8\xAD";
+    std::bernoulli_distribution       pickStructural(density);
+    std::string                       text;
+    text.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        text.push_back(
+            pickStructural(rng) ? kStructural[rng() % std::size(kStructural)] : kPlain[rng() % kPlain.size()]
+        );
+    }
+    return text;
+}
+
+std::string repeatToSize(std::string_view unit, size_t size) {
+    std::string text;
+    text.reserve(size + unit.size());
+    while (text.size() < size) {
+        text.append(unit);
+    }
+    text.resize(size);
+    return text;
+}
+
+} // namespace
+
+// 随机长度（覆盖 16/32 字节块的尾部）与随机密度下，各指令集的输出必须与参考实现一致
+PA_SELF_TEST_CASE(DelimiterScannerDifferential) {
+    std::mt19937_64     rng(0x5043414eULL);
+    std::vector<size_t> expected;
+    std::vector<size_t> actual;
+    size_t              mismatches = 0;
+    for (size_t round = 0; round < 20000; ++round) {
+        size_t      length  = rng() % 300;
+        double      density = static_cast<double>(rng() % 5) / 8.0; // 0 ~ 0.5
+        std::string text    = randomText(rng, length, density);
+
+        expected.clear();
+        bool expectedStart = referenceScan(text, expected);
+        for (SimdLevel level : kLevels) {
+            // 追加语义：out 中已有的内容必须保持不变
+            actual.assign(1, 12345);
+            bool start = DelimiterScanner::scanWith(level, text, actual);
+            bool same  = start == expectedStart && actual.size() == expected.size() + 1 && actual.front() == 12345
+                     && std::equal(expected.begin(), expected.end(), actual.begin() + 1);
+            if (!same && mismatches++ < 5) {
+                auto name = DelimiterScanner::levelName(level);
+                t.check(false, fmt::format("{} differs on input of length {}", name, length));
+            }
+        }
+    }
+    t.check(mismatches == 0, fmt::format("{} mismatch(es)", mismatches));
+}
+
+// 分别测量无占位符的聊天文本与占位符密集的模板在各指令集下的吞吐量
+PA_SELF_TEST_CASE(DelimiterScannerThroughput) {
+    constexpr size_t kTextSize   = 1 << 20;
+    constexpr size_t kIterations = 64;
+
+    const std::pair<const char*, std::string> inputs[] = {
+        {"plain", repeatToSize("Welcome to the server, have a nice day and remember to vote! ", kTextSize)},
+        {"dense", repeatToSize("{player_name} HP {actor_health|precision=1} %server_tps% \\{x\\} ", kTextSize)},
+    };
+
+    t.report(fmt::format("active level: {}", DelimiterScanner::levelName(DelimiterScanner::activeLevel())));
+    std::vector<size_t> out;
+    for (const auto& [label, text] : inputs) {
+        for (SimdLevel level : kLevels) {
+            if (level > DelimiterScanner::activeLevel()) {
+                continue;
+            }
+            double ns = nanosPerOp(kIterations, [&] {
+                out.clear();
+                DelimiterScanner::scanWith(level, text, out);
+                consume(out.size());
+            });
+            double gbPerSecond = static_cast<double>(text.size()) / ns;
+            t.report(fmt::format("{:<5} {:<6} {:7.2f} GB/s", label, DelimiterScanner::levelName(level), gbPerSecond));
+        }
+    }
+}
+
+} // namespace PA::SelfTest
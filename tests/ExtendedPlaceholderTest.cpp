@@ -0,0 +1,115 @@
+// tests/ExtendedPlaceholderTest.cpp
+#include "SelfTest.h"
+#include "PA/PlaceholderProcessor.h"
+#include "PA/PlaceholderRegistry.h"
+#include "PA/TickMemo.h"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PA::SelfTest {
+
+namespace {
+
+// 只实现基线 IPlaceholder 的占位符，模拟按旧头文件编译的插件
+class PlainCountingPlaceholder final : public IPlaceholder {
+public:
+    explicit PlainCountingPlaceholder(std::atomic<int>& calls) : mCalls(calls) {}
+
+    std::string_view token() const noexcept override { return "{plain_count}"; }
+    uint64_t         contextTypeId() const noexcept override { return kServerContextId; }
+    void             evaluate(const IContext*, std::string& out) const override { out = std::to_string(++mCalls); }
+
+private:
+    std::atomic<int>& mCalls;
+};
+
+class StableCountingPlaceholder final : public IExtendedPlaceholder {
+public:
+    explicit StableCountingPlaceholder(std::atomic<int>& calls) : mCalls(calls) {}
+
+    std::string_view token() const noexcept override { return "{stable_count}"; }
+    uint64_t         contextTypeId() const noexcept override { return kServerContextId; }
+    bool             isTickStable() const noexcept override { return true; }
+    void             evaluate(const IContext*, std::string& out) const override { out = std::to_string(++mCalls); }
+
+private:
+    std::atomic<int>& mCalls;
+};
+
+// 类型化与纯文本两种写法输出同一个值，格式化结果应当相同
+class TypedValuePlaceholder final : public IExtendedPlaceholder {
+public:
+    std::string_view token() const noexcept override { return "{typed_value}"; }
+    uint64_t         contextTypeId() const noexcept override { return kServerContextId; }
+    void             evaluate(const IContext*, std::string& out) const override { out = "49.996000"; }
+
+    bool evaluateTyped(const IContext*, const std::vector<std::string_view>&, PlaceholderValue& out) const override {
+        out = PlaceholderValue::ofDouble(49.996);
+        return true;
+    }
+};
+
+class TextValuePlaceholder final : public IPlaceholder {
+public:
+    std::string_view token() const noexcept override { return "{text_value}"; }
+    uint64_t         contextTypeId() const noexcept override { return kServerContextId; }
+    void             evaluate(const IContext*, std::string& out) const override { out = "49.996000"; }
+};
+
+} // namespace
+
+// 扩展接口在注册时检测：只有实现 IExtendedPlaceholder 的占位符参与 tick 备忘，基线占位符照常逐次求值
+PA_SELF_TEST_CASE(ExtendedPlaceholderDetection) {
+    static int          owner = 0;
+    std::atomic<int>    plainCalls{0};
+    std::atomic<int>    stableCalls{0};
+    PlaceholderRegistry registry;
+    registry.registerPlaceholder("", std::make_shared<PlainCountingPlaceholder>(plainCalls), &owner);
+    registry.registerPlaceholder("", std::make_shared<StableCountingPlaceholder>(stableCalls), &owner);
+
+    {
+        RegistryReadGuard guard(registry);
+        size_t            length = 0;
+        t.check(!registry.findLongestPlaceholder(guard, "plain_count", nullptr, length).extended, "plain detected");
+        t.check(registry.findLongestPlaceholder(guard, "stable_count", nullptr, length).extended, "extended missed");
+    }
+
+    auto compiled = PlaceholderProcessor::compile("{plain_count} {stable_count}");
+    TickMemo::enter();
+    const std::string first  = PlaceholderProcessor::process("{plain_count} {stable_count}", nullptr, registry);
+    const std::string second = PlaceholderProcessor::process("{plain_count} {stable_count}", nullptr, registry);
+    const std::string third  = PlaceholderProcessor::render(*compiled, nullptr, registry);
+    TickMemo::exit();
+
+    t.check(first == "1 1" && second == "2 1" && third == "3 1", "tick memo must cover extended placeholders only");
+    t.check(plainCalls.load() == 3 && stableCalls.load() == 1, "unexpected evaluation count");
+}
+
+// 设置精度时颜色阈值与舍入后的文本比较：49.996 保留两位为 50.00，不小于阈值 50
+PA_SELF_TEST_CASE(ExtendedPlaceholderTypedThresholds) {
+    static int          owner = 0;
+    PlaceholderRegistry registry;
+    registry.registerPlaceholder("", std::make_shared<TypedValuePlaceholder>(), &owner);
+    registry.registerPlaceholder("", std::make_shared<TextValuePlaceholder>(), &owner);
+
+    const std::string expected = "\xC2\xA7" "a50.00";
+    for (const char* text : {"{typed_value|precision=2,50,\xC2\xA7" "c,\xC2\xA7" "a}",
+                             "{text_value|precision=2,50,\xC2\xA7" "c,\xC2\xA7" "a}"}) {
+        const std::string rendered = PlaceholderProcessor::process(text, nullptr, registry);
+        t.check(rendered == expected, fmt::format("{} rendered as '{}'", text, rendered));
+
+        auto tpl = PlaceholderProcessor::compile(text);
+        t.check(PlaceholderProcessor::render(*tpl, nullptr, registry) == expected, "compiled render differs");
+    }
+    t.check(
+        PlaceholderProcessor::process("{typed_value}", nullptr, registry) == "49.996000",
+        "typed text form must match evaluate()"
+    );
+}
+
+} // namespace PA::SelfTest
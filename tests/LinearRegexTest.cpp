@@ -0,0 +1,91 @@
+// tests/LinearRegexTest.cpp
+#include "SelfTest.h"
+#include "PA/LinearRegex.h"
+
+#include <fmt/format.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PA::SelfTest {
+
+namespace {
+
+struct NullableLoopCase {
+    std::string_view pattern;
+    std::string_view input;
+    long             begin;      // -1 表示没有匹配
+    long             end;
+    long             groupBegin; // 第 1 组；-1 表示未参与匹配
+    long             groupEnd;
+};
+
+// 期望值取自 ECMAScript 引擎：超出下限的空迭代失败，回溯到其他选择
+constexpr NullableLoopCase kNullableLoops[] = {
+    {"(a*)*b", "aaab", 0, 4, 0, 3},
+    {"(a*)*b", "aaaa", -1, -1, -1, -1},
+    {"(a|)*b", "xaab", 1, 4, 2, 3},
+    {"(\\w*)*$", "ab cd", 3, 5, 3, 5},
+    {"(.*)*x", "abcx", 0, 4, 0, 3},
+    {"(a*?)+", "aa", 0, 2, 1, 2},
+    {"(a*){2,3}b", "aab", 0, 3, 2, 2},
+};
+
+} // namespace
+
+// 循环体可匹配空串的量词由线性引擎处理，结果与 ECMAScript 一致
+PA_SELF_TEST_CASE(LinearRegexNullableLoops) {
+    LinearRegex::Scratch           scratch;
+    std::vector<LinearRegex::Span> groups;
+    for (const auto& c : kNullableLoops) {
+        auto regex = LinearRegex::compile(c.pattern);
+        if (!regex) {
+            t.check(false, fmt::format("/{}/ rejected by the linear engine", c.pattern));
+            continue;
+        }
+        const bool matched = regex->search(c.input, 0, false, groups, scratch);
+        if (c.begin < 0) {
+            t.check(!matched, fmt::format("/{}/ must not match '{}'", c.pattern, c.input));
+            continue;
+        }
+        const auto span = [](const LinearRegex::Span& s) {
+            return s.matched() ? fmt::format("[{},{}]", s.begin, s.end) : std::string("unmatched");
+        };
+        const auto want = [](long b, long e) {
+            return b < 0 ? std::string("unmatched") : fmt::format("[{},{}]", b, e);
+        };
+        const auto whole = matched ? span(groups[0]) : std::string("no match");
+        const auto group = matched ? span(groups[1]) : std::string("no match");
+        t.check(
+            whole == want(c.begin, c.end) && group == want(c.groupBegin, c.groupEnd),
+            fmt::format("/{}/ on '{}': {} {}", c.pattern, c.input, whole, group)
+        );
+    }
+
+    // 嵌套超过 3 层的此类循环不支持，交给 std::regex
+    t.check(!LinearRegex::compile("((((a*)*)*)*)*b"), "deeply nested nullable loops must be rejected");
+}
+
+// 回溯引擎上指数级的写法在线性引擎上随输入长度线性增长
+PA_SELF_TEST_CASE(LinearRegexNullableLoopsLinearTime) {
+    LinearRegex::Scratch           scratch;
+    std::vector<LinearRegex::Span> groups;
+    for (std::string_view pattern : {"(a*)*b", "(a|)*b", "(\\w*)*$", "(.*)*x"}) {
+        auto regex = LinearRegex::compile(pattern);
+        if (!regex) {
+            t.check(false, fmt::format("/{}/ rejected by the linear engine", pattern));
+            continue;
+        }
+        auto run = [&](size_t length) {
+            const std::string input = std::string(length, 'a') + "!";
+            return nanosPerOp(20, [&] { consume(regex->search(input, 0, false, groups, scratch)); });
+        };
+        const double shortNs = run(1000);
+        const double longNs  = run(8000);
+        t.report(fmt::format("/{}/ 1000 chars {:9.0f} ns, 8000 chars {:9.0f} ns", pattern, shortNs, longNs));
+        t.check(longNs < shortNs * 24, fmt::format("/{}/ grows faster than linearly", pattern));
+    }
+}
+
+} // namespace PA::SelfTest
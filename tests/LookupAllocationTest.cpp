@@ -0,0 +1,108 @@
+// tests/LookupAllocationTest.cpp
+#include "SelfTest.h"
+#include "PA/PlaceholderRegistry.h"
+
+#include <fmt/format.h>
+
+#include <memory>
+#include <string>
+
+namespace PA::SelfTest {
+
+namespace {
+
+struct AllocTestContext : public IContext {
+    static constexpr uint64_t kTypeId = TypeId("ctx:SelfTestAlloc");
+
+    uint64_t typeId() const noexcept override { return kTypeId; }
+
+    const std::vector<uint64_t>& getInheritedTypeIds() const noexcept override {
+        static const std::vector<uint64_t> ids = {kTypeId};
+        return ids;
+    }
+
+    std::string getContextInstanceKey() const noexcept override { return "alloc-test"; }
+};
+
+class FixedPlaceholder final : public IPlaceholder {
+public:
+    FixedPlaceholder(std::string token, uint64_t contextTypeId)
+    : mToken(std::move(token)),
+      mContextTypeId(contextTypeId) {}
+
+    std::string_view token() const noexcept override { return mToken; }
+    uint64_t         contextTypeId() const noexcept override { return mContextTypeId; }
+    void             evaluate(const IContext*, std::string& out) const override { out = "1"; }
+
+private:
+    std::string mToken;
+    uint64_t    mContextTypeId;
+};
+
+} // namespace
+
+// token 解析（最长 token 查找）在命中、未命中与缓存占位符上都不应产生堆分配
+PA_SELF_TEST_CASE(LookupZeroAllocation) {
+    // 先确认计数的 operator new 已生效，否则下面的断言恒成立
+    uint64_t baseline = threadAllocations();
+    consume(std::make_unique<std::string>(64, 'x')->size());
+    t.check(threadAllocations() > baseline, "allocation counter is not hooked");
+
+    static int          owner = 0;
+    PlaceholderRegistry registry;
+    registry.registerPlaceholder(
+        "MyPlugin",
+        std::make_shared<FixedPlaceholder>("{long_statistic_name}", kServerContextId),
+        &owner
+    );
+    registry.registerPlaceholder(
+        "MyPlugin",
+        std::make_shared<FixedPlaceholder>("{typed_value}", AllocTestContext::kTypeId),
+        &owner
+    );
+    registry.registerCachedPlaceholder(
+        "",
+        std::make_shared<FixedPlaceholder>("{cached_online}", kServerContextId),
+        &owner,
+        5
+    );
+
+    AllocTestContext ctx;
+    struct Probe {
+        std::string_view input;
+        const IContext*  ctx;
+        bool             expectHit;
+        size_t           expectTokenLength;
+    };
+    const Probe probes[] = {
+        {"MyPlugin:long_statistic_name:arg1:arg2:arg3", nullptr, true, 28},
+        {"MYPLUGIN:LONG_STATISTIC_NAME:arg1", &ctx, true, 28},
+        {"myplugin:typed_value:x:y", &ctx, true, 20},
+        {"cached_online", nullptr, true, 13},
+        {"MyPlugin:unknown:arg", nullptr, false, 0},
+        {"\"json\":\"value\",\"n\":1", nullptr, false, 0},
+    };
+
+    for (const auto& probe : probes) {
+        // 首次查找会为新的上下文类型构建解析表、登记线程的 epoch 记录，先预热一次
+        for (int round = 0; round < 2; ++round) {
+            size_t   tokenLength = 0;
+            uint64_t before      = threadAllocations();
+            bool     hit         = false;
+            {
+                RegistryReadGuard guard(registry);
+                auto              found = registry.findLongestPlaceholder(guard, probe.input, probe.ctx, tokenLength);
+                hit                     = found.placeholder != nullptr;
+            }
+            uint64_t allocations = threadAllocations() - before;
+            if (round == 0) {
+                continue;
+            }
+            t.check(hit == probe.expectHit, fmt::format("unexpected lookup result for '{}'", probe.input));
+            t.check(!hit || tokenLength == probe.expectTokenLength, fmt::format("token length for '{}'", probe.input));
+            t.check(allocations == 0, fmt::format("'{}' allocated {} time(s)", probe.input, allocations));
+        }
+    }
+}
+
+} // namespace PA::SelfTest
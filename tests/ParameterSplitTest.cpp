@@ -0,0 +1,59 @@
+// tests/ParameterSplitTest.cpp
+#include "SelfTest.h"
+#include "PA/PlaceholderProcessor.h"
+#include "PA/PlaceholderRegistry.h"
+
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PA::SelfTest {
+
+namespace {
+
+// 以 ';' 拼接收到的参数，模拟 {math:<expr>} 这类原样接收嵌套占位符的占位符
+class EchoArgsPlaceholder final : public IPlaceholder {
+public:
+    std::string_view token() const noexcept override { return "{echo_args}"; }
+    uint64_t         contextTypeId() const noexcept override { return kServerContextId; }
+    void             evaluate(const IContext*, std::string& out) const override { out = "-"; }
+
+    void evaluateWithArgs(const IContext*, const std::vector<std::string_view>& args, std::string& out) const override {
+        out = fmt::format("{}", fmt::join(args, ";"));
+    }
+};
+
+struct SplitCase {
+    std::string_view text;
+    std::string_view expected;
+};
+
+// 花括号内的 '|' 属于嵌套占位符自己的格式化参数，不切分外层参数
+constexpr SplitCase kSplitCases[] = {
+    {"{echo_args:{inner|precision=1}*2}", "{inner|precision=1}*2"},
+    {"{echo_args:{inner|precision=1}*2|map=>0:pos;neg}", "{inner|precision=1}*2"},
+    {"{echo_args:a,{b|precision=0},c|precision=1}", "a;{b|precision=0};c"},
+    {"{echo_args:x|map=>0:pos;neg}", "x"},
+};
+
+} // namespace
+
+PA_SELF_TEST_CASE(ParameterSplitNestedPipe) {
+    static int          owner = 0;
+    PlaceholderRegistry registry;
+    registry.registerPlaceholder("", std::make_shared<EchoArgsPlaceholder>(), &owner);
+
+    for (const auto& c : kSplitCases) {
+        const std::string processed = PlaceholderProcessor::process(c.text, nullptr, registry);
+        t.check(processed == c.expected, fmt::format("{} processed as '{}'", c.text, processed));
+
+        auto              tpl      = PlaceholderProcessor::compile(c.text);
+        const std::string rendered = PlaceholderProcessor::render(*tpl, nullptr, registry);
+        t.check(rendered == c.expected, fmt::format("{} rendered as '{}'", c.text, rendered));
+    }
+}
+
+} // namespace PA::SelfTest
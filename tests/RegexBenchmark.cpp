@@ -0,0 +1,89 @@
+// tests/RegexBenchmark.cpp
+#include "SelfTest.h"
+#include "PA/LinearRegex.h"
+#include "PA/ParameterParser.h"
+
+#include <fmt/format.h>
+
+#include <regex>
+#include <string>
+#include <string_view>
+
+namespace PA::SelfTest {
+
+namespace {
+
+struct RegexCase {
+    std::string_view label;
+    std::string_view pattern;
+    std::string_view replacement;
+    std::string_view input;
+};
+
+// 聊天前缀与计分板中常见的颜色代码清理、玩家名规整
+constexpr RegexCase kCases[] = {
+    {"strip section codes",
+     "\xC2\xA7[0-9a-fk-or]",
+     "",
+     "\xC2\xA7" "a[VIP] \xC2\xA7" "bSteve\xC2\xA7r: \xC2\xA7" "ehello \xC2\xA7lworld\xC2\xA7r, HP \xC2\xA7" "c20"},
+    {"strip ampersand codes", "&[0-9a-fk-or]", "", "&6&l[Admin]&r &7Alex &8>> &fwelcome to &bthe server&r!"},
+    {"sanitize name", "[^A-Za-z0-9_]", "_", "  Steve-The.Builder 2024 (AFK)  "},
+    {"trim name", "^\\s+|\\s+$", "", "   Notch   "},
+    {"collapse spaces", "\\s{2,}", " ", "a  b   c    d     e  [tag]   name"},
+};
+
+ParameterParser::RegexReplaceMap makeMap(const RegexCase& regexCase, bool linear) {
+    ParameterParser::RegexReplaceRule rule;
+    rule.replacement = std::string(regexCase.replacement);
+    if (linear) {
+        rule.linear = LinearRegex::compile(regexCase.pattern);
+    } else {
+        rule.fallback.emplace(std::string(regexCase.pattern), std::regex_constants::optimize);
+    }
+    ParameterParser::RegexReplaceMap map;
+    map.enabled = true;
+    map.mappings.push_back(std::move(rule));
+    return map;
+}
+
+} // namespace
+
+// regex_map 两种引擎在颜色代码与名称清理上的对拍与耗时；按占位符值的典型长度逐次替换
+PA_SELF_TEST_CASE(RegexEngineBenchmark) {
+    constexpr size_t kIterations = 20000;
+
+    for (const auto& regexCase : kCases) {
+        auto linear   = makeMap(regexCase, true);
+        auto standard = makeMap(regexCase, false);
+        if (!linear.mappings.front().linear) {
+            t.check(false, fmt::format("{}: pattern rejected by the linear engine", regexCase.label));
+            continue;
+        }
+
+        std::string linearOut(regexCase.input);
+        std::string stdOut(regexCase.input);
+        ParameterParser::applyRegexReplaceMap(linearOut, linear);
+        ParameterParser::applyRegexReplaceMap(stdOut, standard);
+        t.check(linearOut == stdOut, fmt::format("{}: '{}' != '{}'", regexCase.label, linearOut, stdOut));
+
+        std::string value;
+        auto        run = [&](const ParameterParser::RegexReplaceMap& map) {
+            return nanosPerOp(kIterations, [&] {
+                value.assign(regexCase.input);
+                ParameterParser::applyRegexReplaceMap(value, map);
+                consume(value.size());
+            });
+        };
+        const double linearNs = run(linear);
+        const double stdNs    = run(standard);
+        t.report(fmt::format(
+            "{:<22} linear {:8.1f} ns, std::regex {:8.1f} ns ({:4.1f}x)",
+            regexCase.label,
+            linearNs,
+            stdNs,
+            linearNs > 0 ? stdNs / linearNs : 0.0
+        ));
+    }
+}
+
+} // namespace PA::SelfTest
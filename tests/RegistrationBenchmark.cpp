@@ -0,0 +1,208 @@
+// tests/RegistrationBenchmark.cpp
+#include "SelfTest.h"
+#include "PA/BuiltinPlaceholders.h"
+#include "PA/PlaceholderProcessor.h"
+#include "PA/PlaceholderRegistry.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace PA::SelfTest {
+
+namespace {
+
+/**
+ * @brief 基于独立注册表的占位符服务，只用于测量注册与反注册
+ * 记录出现过的 owner，便于随后逐一反注册；batching 为 false 时忽略 beginBatch()/commitBatch()，
+ * 模拟每次注册都发布一次快照的旧行为作为对照
+ */
+class RegistryService final : public IPlaceholderService {
+public:
+    explicit RegistryService(bool batching) : mBatching(batching) {}
+
+    PlaceholderRegistry&      registry() noexcept { return mRegistry; }
+    const std::vector<void*>& owners() const noexcept { return mOwners; }
+
+    void registerPlaceholder(std::string_view prefix, std::shared_ptr<const IPlaceholder> p, void* owner) override {
+        track(owner);
+        mRegistry.registerPlaceholder(prefix, p, owner);
+    }
+
+    void registerCachedPlaceholder(
+        std::string_view                    prefix,
+        std::shared_ptr<const IPlaceholder> p,
+        void*                               owner,
+        unsigned int                        cacheDuration
+    ) override {
+        track(owner);
+        mRegistry.registerCachedPlaceholder(prefix, p, owner, cacheDuration);
+    }
+
+    void registerRelationalPlaceholder(
+        std::string_view                    prefix,
+        std::shared_ptr<const IPlaceholder> p,
+        void*                               owner,
+        uint64_t                            mainContextTypeId,
+        uint64_t                            relationalContextTypeId
+    ) override {
+        track(owner);
+        mRegistry.registerRelationalPlaceholder(prefix, p, owner, mainContextTypeId, relationalContextTypeId);
+    }
+
+    void registerCachedRelationalPlaceholder(
+        std::string_view                    prefix,
+        std::shared_ptr<const IPlaceholder> p,
+        void*                               owner,
+        uint64_t                            mainContextTypeId,
+        uint64_t                            relationalContextTypeId,
+        unsigned int                        cacheDuration
+    ) override {
+        track(owner);
+        mRegistry.registerCachedRelationalPlaceholder(
+            prefix,
+            p,
+            owner,
+            mainContextTypeId,
+            relationalContextTypeId,
+            cacheDuration
+        );
+    }
+
+    void unregisterByOwner(void* owner) override { mRegistry.unregisterByOwner(owner); }
+
+    std::unique_ptr<IScopedPlaceholderRegistrar> createScopedRegistrar(void* owner) override {
+        track(owner);
+        return std::make_unique<ScopedPlaceholderRegistrar>(&mRegistry, owner);
+    }
+
+    std::string replace(std::string_view text, const IContext* ctx) const override {
+        return PlaceholderProcessor::process(text, ctx, mRegistry);
+    }
+
+    std::string replaceServer(std::string_view text) const override {
+        return PlaceholderProcessor::processServer(text, mRegistry);
+    }
+
+    void registerContextAlias(
+        std::string_view  alias,
+        uint64_t          fromContextTypeId,
+        uint64_t          toContextTypeId,
+        ContextResolverFn resolver,
+        void*             owner
+    ) override {
+        track(owner);
+        mRegistry.registerContextAlias(alias, fromContextTypeId, toContextTypeId, resolver, owner);
+    }
+
+    void registerContextFactory(uint64_t contextTypeId, ContextFactoryFn factory, void* owner) override {
+        track(owner);
+        mRegistry.registerContextFactory(contextTypeId, factory, owner);
+    }
+
+    CompiledTemplateHandle compile(std::string_view text) const override { return PlaceholderProcessor::compile(text); }
+
+    std::string render(const CompiledTemplateHandle& tpl, const IContext* ctx) const override {
+        return tpl ? PlaceholderProcessor::render(*tpl, ctx, mRegistry) : std::string();
+    }
+
+    TemplateCacheStats getTemplateCacheStats() const override { return {}; }
+
+    void beginBatch() override {
+        if (mBatching) {
+            mRegistry.beginBatch();
+        }
+    }
+
+    void commitBatch() override {
+        if (mBatching) {
+            mRegistry.commitBatch();
+        }
+    }
+
+    ValueCacheStats getValueCacheStats() const override { return {}; }
+    void            invalidateInstance(uint64_t) override {}
+    void            setCacheExecutor(CacheExecutor) override {}
+    void            beginEvaluationScope() override {}
+    void            endEvaluationScope() override {}
+
+private:
+    void track(void* owner) {
+        if (std::find(mOwners.begin(), mOwners.end(), owner) == mOwners.end()) {
+            mOwners.push_back(owner);
+        }
+    }
+
+    bool                mBatching;
+    PlaceholderRegistry mRegistry;
+    std::vector<void*>  mOwners;
+};
+
+struct StartupSample {
+    double   registerMs{};
+    double   unregisterMs{};
+    uint64_t registerPublishes{};
+    uint64_t unregisterPublishes{};
+};
+
+double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+StartupSample measureStartup(bool batching) {
+    StartupSample   sample;
+    RegistryService service(batching);
+    auto&           registry = service.registry();
+
+    uint64_t version = registry.getVersion();
+    auto     start   = std::chrono::steady_clock::now();
+    registerAllBuiltinPlaceholders(&service);
+    sample.registerMs        = millisSince(start);
+    sample.registerPublishes = registry.getVersion() - version;
+
+    version = registry.getVersion();
+    start   = std::chrono::steady_clock::now();
+    {
+        PlaceholderBatch batch(&service);
+        for (void* owner : service.owners()) {
+            service.unregisterByOwner(owner);
+        }
+    }
+    sample.unregisterMs        = millisSince(start);
+    sample.unregisterPublishes = registry.getVersion() - version;
+    return sample;
+}
+
+} // namespace
+
+// 全部内置占位符的注册与按 owner 反注册：批量事务只发布一次快照，对照组每次修改都发布
+PA_SELF_TEST_CASE(RegistrationStartupBenchmark) {
+    constexpr int kRounds = 5;
+
+    for (bool batching : {false, true}) {
+        StartupSample total;
+        StartupSample last;
+        for (int round = 0; round < kRounds; ++round) {
+            last                = measureStartup(batching);
+            total.registerMs   += last.registerMs;
+            total.unregisterMs += last.unregisterMs;
+        }
+        t.report(fmt::format(
+            "{:<9} register {:8.3f} ms ({} publish(es)), unregister {:8.3f} ms ({} publish(es))",
+            batching ? "batched" : "unbatched",
+            total.registerMs / kRounds,
+            last.registerPublishes,
+            total.unregisterMs / kRounds,
+            last.unregisterPublishes
+        ));
+        if (batching) {
+            t.check(last.registerPublishes == 1, "batched registration must publish exactly once");
+            t.check(last.unregisterPublishes <= 1, "batched unregistration must publish at most once");
+        }
+    }
+}
+
+} // namespace PA::SelfTest
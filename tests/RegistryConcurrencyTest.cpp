@@ -0,0 +1,144 @@
+// tests/RegistryConcurrencyTest.cpp
+#include "SelfTest.h"
+#include "PA/PlaceholderProcessor.h"
+#include "PA/PlaceholderRegistry.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PA::SelfTest {
+
+namespace {
+
+class CountingPlaceholder final : public IPlaceholder {
+public:
+    CountingPlaceholder(std::string token, std::atomic<int>* destroyed = nullptr)
+    : mToken(std::move(token)),
+      mDestroyed(destroyed) {}
+
+    ~CountingPlaceholder() override {
+        if (mDestroyed) {
+            mDestroyed->fetch_add(1);
+        }
+    }
+
+    std::string_view token() const noexcept override { return mToken; }
+    uint64_t         contextTypeId() const noexcept override { return kServerContextId; }
+    void             evaluate(const IContext*, std::string& out) const override { out = "42"; }
+
+private:
+    std::string       mToken;
+    std::atomic<int>* mDestroyed;
+};
+
+// 在 timeout 内等待 condition 成立；自检在服务器上运行时其他线程可能仍短暂停留在读临界区
+template <typename Fn>
+bool waitFor(Fn&& condition, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+// 发布时仍被读者阻挡的旧快照，应在该读者离开后释放，而不必等待下一次发布
+PA_SELF_TEST_CASE(EpochReclaimOnReaderExit) {
+    static int          owner     = 0;
+    std::atomic<int>    destroyed = 0;
+    PlaceholderRegistry registry;
+    registry.registerPlaceholder("", std::make_shared<CountingPlaceholder>("{epoch_probe}", &destroyed), &owner);
+
+    {
+        RegistryReadGuard guard(registry);
+        registry.unregisterByOwner(&owner);
+        t.check(destroyed.load() == 0, "snapshot reclaimed while a reader still holds it");
+    }
+    t.check(
+        waitFor([&] { return destroyed.load() == 1; }, std::chrono::milliseconds(1000)),
+        "retired snapshot not reclaimed after the last reader left"
+    );
+}
+
+// 多线程同时渲染，对照有无并发发布时的吞吐量；读者只在查找期间停留在读临界区
+PA_SELF_TEST_CASE(RegistryReadScaling) {
+    static int          owner      = 0;
+    static int          churnOwner = 0;
+    constexpr auto      kDuration  = std::chrono::milliseconds(200);
+    const std::string   text       = "HP {bench_a} / {bench_b} at {bench_c|precision=2}, plain tail text";
+    const std::string   expected   = "HP 42 / 42 at 42.00, plain tail text";
+    PlaceholderRegistry registry;
+    for (const char* token : {"{bench_a}", "{bench_b}", "{bench_c}"}) {
+        registry.registerPlaceholder("", std::make_shared<CountingPlaceholder>(token), &owner);
+    }
+
+    const unsigned maxThreads = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+    for (bool churn : {false, true}) {
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            std::atomic<bool>     stop{false};
+            std::atomic<uint64_t> renders{0};
+            std::atomic<uint64_t> wrong{0};
+            std::atomic<uint64_t> publishes{0};
+
+            std::vector<std::thread> workers;
+            for (unsigned i = 0; i < threads; ++i) {
+                workers.emplace_back([&] {
+                    uint64_t local = 0;
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        if (PlaceholderProcessor::process(text, nullptr, registry) != expected) {
+                            wrong.fetch_add(1, std::memory_order_relaxed);
+                        }
+                        ++local;
+                    }
+                    renders.fetch_add(local);
+                });
+            }
+            std::thread publisher;
+            if (churn) {
+                // 不相关 token 的反复注册与反注册，使旧快照在读者仍活跃时不断退役
+                publisher = std::thread([&] {
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        auto placeholder = std::make_shared<CountingPlaceholder>("{churn}");
+                        registry.registerPlaceholder("", placeholder, &churnOwner);
+                        registry.unregisterByOwner(&churnOwner);
+                        publishes.fetch_add(2, std::memory_order_relaxed);
+                        std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    }
+                });
+            }
+
+            std::this_thread::sleep_for(kDuration);
+            stop.store(true);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            if (publisher.joinable()) {
+                publisher.join();
+            }
+
+            const double seconds = std::chrono::duration<double>(kDuration).count();
+            t.report(fmt::format(
+                "{:<8} {} thread(s): {:10.0f} renders/s ({:8.0f} per thread), {} publish(es)",
+                churn ? "churn" : "steady",
+                threads,
+                static_cast<double>(renders.load()) / seconds,
+                static_cast<double>(renders.load()) / seconds / threads,
+                publishes.load()
+            ));
+            t.check(wrong.load() == 0, fmt::format("{} render(s) produced wrong output", wrong.load()));
+        }
+    }
+}
+
+} // namespace PA::SelfTest
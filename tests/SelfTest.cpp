@@ -0,0 +1,58 @@
+// tests/SelfTest.cpp
+#include "SelfTest.h"
+#include "PA/logger.h"
+
+#include <atomic>
+#include <vector>
+
+namespace PA::SelfTest {
+
+namespace {
+
+struct Case {
+    const char* name;
+    CaseFn      fn;
+};
+
+std::vector<Case>& cases() {
+    static std::vector<Case> instance;
+    return instance;
+}
+
+std::atomic<size_t> gSink{0};
+
+} // namespace
+
+void Context::check(bool condition, std::string_view what) {
+    if (!condition) {
+        ++mFailures;
+        logger.error("[selftest] {}: check failed: {}", mName, what);
+    }
+}
+
+void Context::report(std::string_view line) { logger.info("[selftest] {}: {}", mName, line); }
+
+bool registerCase(const char* name, CaseFn fn) {
+    cases().push_back({name, fn});
+    return true;
+}
+
+size_t runAll() {
+    size_t failed = 0;
+    for (const auto& entry : cases()) {
+        Context ctx(entry.name);
+        entry.fn(ctx);
+        if (ctx.failed()) {
+            ++failed;
+            logger.error("[selftest] {} FAILED", entry.name);
+        } else {
+            logger.info("[selftest] {} passed", entry.name);
+        }
+    }
+    logger.info("[selftest] {} case(s), {} failed", cases().size(), failed);
+    return failed;
+}
+
+void consume(size_t value) noexcept { gSink.fetch_add(value, std::memory_order_relaxed); }
+
+} // namespace PA::SelfTest
@@ -0,0 +1,62 @@
+// tests/SelfTest.h
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace PA::SelfTest {
+
+/**
+ * @brief 单个自检用例的执行上下文
+ * 自检与基准测试只在 `xmake f --selftest=y` 时编译进插件，启用插件时依次运行并把结果写入日志。
+ * check() 记录失败但不中断用例；report() 输出基准测试数据等附加信息。
+ */
+class Context {
+public:
+    explicit Context(std::string_view name) : mName(name) {}
+
+    void check(bool condition, std::string_view what);
+    void report(std::string_view line);
+
+    bool             failed() const noexcept { return mFailures != 0; }
+    std::string_view name() const noexcept { return mName; }
+
+private:
+    std::string mName;
+    size_t      mFailures{};
+};
+
+using CaseFn = void (*)(Context&);
+
+// 注册用例，返回值仅用于在静态初始化阶段调用
+bool registerCase(const char* name, CaseFn fn);
+
+// 按注册顺序运行全部用例，返回失败的用例数
+size_t runAll();
+
+// 防止基准测试的计算结果被优化掉
+void consume(size_t value) noexcept;
+
+// 当前线程累计的堆分配次数（由 Entry/MemoryOperators.cpp 中计数的 operator new 维护）
+uint64_t threadAllocations() noexcept;
+
+// 执行 fn 共 iterations 次，返回平均每次耗时（纳秒）
+template <typename Fn>
+double nanosPerOp(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return iterations ? elapsed.count() / static_cast<double>(iterations) : 0.0;
+}
+
+} // namespace PA::SelfTest
+
+#define PA_SELF_TEST_CASE(name)                                                                                        \
+    static void       name(::PA::SelfTest::Context& t);                                                                \
+    static const bool name##Registered = ::PA::SelfTest::registerCase(#name, &name);                                   \
+    static void       name(::PA::SelfTest::Context& t)
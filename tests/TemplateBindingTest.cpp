@@ -0,0 +1,60 @@
+// tests/TemplateBindingTest.cpp
+#include "SelfTest.h"
+#include "PA/CompiledTemplate.h"
+#include "PA/FormatCache.h"
+#include "PA/PlaceholderProcessor.h"
+#include "PA/PlaceholderRegistry.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace PA::SelfTest {
+
+namespace {
+
+class NamePlaceholder final : public IPlaceholder {
+public:
+    std::string_view token() const noexcept override { return "{binding_name}"; }
+    uint64_t         contextTypeId() const noexcept override { return kServerContextId; }
+    void             evaluate(const IContext*, std::string& out) const override { out = "abc"; }
+};
+
+// 模板对当前上下文类型的绑定；未绑定时返回 nullptr
+std::shared_ptr<const TemplateBinding> currentBinding(const CompiledTemplate& tpl) {
+    std::lock_guard<std::mutex> lock(tpl.bindingMutex);
+    return tpl.bindings.empty() ? nullptr : tpl.bindings.front();
+}
+
+bool usesStdRegex(const TemplateBinding& binding) {
+    const auto& node = binding.nodes.front();
+    return node.formatting && !node.formatting->regexReplaceMap.mappings.empty()
+        && node.formatting->regexReplaceMap.mappings.front().fallback.has_value();
+}
+
+} // namespace
+
+// 插件长期持有的模板句柄不在模板缓存中：切换正则引擎后，其绑定应随 FormatCache 代数变化而重建
+PA_SELF_TEST_CASE(TemplateBindingRegexEngineSwitch) {
+    static int          owner = 0;
+    PlaceholderRegistry registry;
+    registry.registerPlaceholder("", std::make_shared<NamePlaceholder>(), &owner);
+
+    auto tpl = PlaceholderProcessor::compile("{binding_name|regex_map=b:X}");
+    t.check(PlaceholderProcessor::render(*tpl, nullptr, registry) == "aXc", "render with the linear engine");
+    auto linearBinding = currentBinding(*tpl);
+    t.check(linearBinding && !usesStdRegex(*linearBinding), "rule must be compiled by the linear engine");
+
+    ParameterParser::setRegexEngine(ParameterParser::RegexEngine::Std);
+    FormatCache::global().clear();
+    t.check(PlaceholderProcessor::render(*tpl, nullptr, registry) == "aXc", "render with the std engine");
+    auto stdBinding = currentBinding(*tpl);
+    t.check(stdBinding && stdBinding != linearBinding, "binding must be rebuilt after the engine switch");
+    t.check(stdBinding && usesStdRegex(*stdBinding), "rebuilt rule must use std::regex");
+
+    ParameterParser::setRegexEngine(ParameterParser::RegexEngine::Linear);
+    FormatCache::global().clear();
+    t.check(PlaceholderProcessor::render(*tpl, nullptr, registry) == "aXc", "render after restoring the engine");
+}
+
+} // namespace PA::SelfTest
@@ -28,6 +28,12 @@ option("target_type")
     set_values("server", "client")
 option_end()
 
+-- 自检与基准测试（tests/），默认不编译：xmake f --selftest=y
+option("selftest")
+    set_default(false)
+    set_showmenu(true)
+option_end()
+
 target("Placeholder") -- Change this to your mod name.
     add_rules("@levibuildscript/linkrule")
     add_rules("@levibuildscript/modpacker")
@@ -41,6 +47,11 @@ target("Placeholder") -- Change this to your mod name.
     add_headerfiles("src/**.h")
     add_files("src/**.cpp")
     add_includedirs("src")
+    if has_config("selftest") then
+        add_files("tests/**.cpp")
+        add_includedirs("tests")
+        add_defines("PA_SELF_TEST")
+    end
     -- if is_config("target_type", "server") then
     --     add_includedirs("src-server")
     --     add_files("src-server/**.cpp")